@@ -2,7 +2,39 @@
 #include <string>
 #include <memory>
 #include <map>
+#include <vector>
+#include <deque>
+#include <array>
+#include <thread>
+#include <condition_variable>
+#include <cstdint>
+#include <atomic>
+#include <list>
+#include <queue>
+#include <random>
+#include <unordered_map>
+#include <type_traits>
+#include <utility>
+#include <string_view>
+#include <charconv>
+#include <optional>
+#include <functional>
+#include <shared_mutex>
+#include <future>
+#include <algorithm>
+#include <numeric>
+#include <tuple>
+#include <variant>
+#include <cmath>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
 #include <stdexcept>
+#include <new>
+#include <cstdlib>
 
 using namespace std;
 
@@ -10,468 +42,5805 @@ using namespace std;
 //  GOOD EXAMPLE - Loose Coupling with Abstractions
 
 //  STEP 1: Create Abstractions (Interfaces)
+
+// View read-only ke deretan Order yang bersebelahan (pointer + jumlah) - pemanggil
+// bisa mengirim sebagian vector tanpa menyalin Order-nya
+class OrderSpan {
+private:
+    const Order* first;
+    size_t count;
+
+public:
+    OrderSpan(const Order* orders, size_t orderCount)
+        : first(orders), count(orderCount) {
+    }
+
+    OrderSpan(const vector<Order>& orders)
+        : first(orders.data()), count(orders.size()) {
+    }
+
+    const Order* begin() const { return first; }
+    const Order* end() const { return first + count; }
+    const Order& operator[](size_t index) const { return first[index]; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    // Potongan [offset, offset + length), dipotong di ujung view
+    OrderSpan subspan(size_t offset, size_t length) const {
+        offset = min(offset, count);
+        return OrderSpan(first + offset, min(length, count - offset));
+    }
+};
+
+// View read-only ke deretan id (pointer + jumlah), bentuknya sama dengan OrderSpan -
+// pemanggil bisa mengirim array biasa atau sebagian vector tanpa menyalin id-nya
+class IdSpan {
+private:
+    const int* first;
+    size_t count;
+
+public:
+    IdSpan(const int* ids, size_t idCount)
+        : first(ids), count(idCount) {
+    }
+
+    IdSpan(const vector<int>& ids)
+        : first(ids.data()), count(ids.size()) {
+    }
+
+    const int* begin() const { return first; }
+    const int* end() const { return first + count; }
+    int operator[](size_t index) const { return first[index]; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    // Potongan [offset, offset + length), dipotong di ujung view
+    IdSpan subspan(size_t offset, size_t length) const {
+        offset = min(offset, count);
+        return IdSpan(first + offset, min(length, count - offset));
+    }
+};
+
 class DatabaseService {
 public:
     virtual ~DatabaseService() = default;
     virtual void save(const Order& order) = 0;
     virtual Order findById(int id) = 0;
     virtual string getType() const = 0;
+
+    // Batch write - default implementation: satu save() per order
+    virtual void saveBatch(OrderSpan orders) {
+        for (const auto& order : orders) {
+            save(order);
+        }
+    }
+
+    // Batch lookup: order yang ketemu di-append ke found (urutan tidak dijamin),
+    // id yang tidak ada di-append ke missing - tanpa exception.
+    // Default implementation: satu findById() per id.
+    virtual void findByIds(IdSpan ids, vector<Order>& found, vector<int>& missing) {
+        for (int id : ids) {
+            try {
+                found.push_back(findById(id));
+            }
+            catch (const out_of_range&) {
+                missing.push_back(id);
+            }
+        }
+    }
+};
+
+// Hasil pengiriman yang bisa dicek tanpa exception
+struct SendResult {
+    bool delivered = true;
+    string error;
 };
 
 class NotificationService {
 public:
     virtual ~NotificationService() = default;
-    virtual void send(const string& message) = 0;
+    virtual void send(string_view message) = 0;
     virtual string getType() const = 0;
+
+    // Send dengan hasil eksplisit - default implementation: exception dari send() jadi error
+    virtual SendResult trySend(string_view message) {
+        try {
+            send(message);
+            return SendResult{};
+        }
+        catch (const exception& error) {
+            return SendResult{ false, error.what() };
+        }
+    }
 };
 
 //  STEP 2: Concrete Implementations
+
+// Helper: splitmix64 finalizer - hash 64-bit yang menyebar rata untuk id berurutan
+uint64_t mixHash(uint64_t value) {
+    value += 0x9E3779B97F4A7C15ULL;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+    return value ^ (value >> 31);
+}
+
+// Helper: "1, 2, 3" untuk query IN (...) / $in
+string joinIds(IdSpan ids) {
+    string joined;
+    for (size_t i = 0; i < ids.size(); ++i) {
+        if (i > 0) {
+            joined += ", ";
+        }
+        joined += to_string(ids[i]);
+    }
+    return joined;
+}
+
+// Helper: satu multi-row INSERT untuk seluruh batch (dipakai backend SQL)
+string buildMultiRowInsert(OrderSpan orders) {
+    string statement = "INSERT INTO orders (id, description, amount) VALUES ";
+    statement.reserve(statement.size() + orders.size() * 64);
+
+    for (size_t i = 0; i < orders.size(); ++i) {
+        if (i > 0) {
+            statement += ", ";
+        }
+        char number[32];
+        statement += '(';
+        statement.append(number, to_chars(number, number + sizeof(number), orders[i].getId()).ptr);
+        statement += ", '";
+        for (char c : orders[i].getDescription()) {
+            if (c == '\'') {
+                statement += '\''; // SQL escaping: ' menjadi ''
+            }
+            statement += c;
+        }
+        statement += "', ";
+        statement.append(number, orders[i].getTotalAmount().formatTo(number, number + sizeof(number)));
+        statement += ')';
+    }
+    return statement;
+}
+
 class MySQLDatabase : public DatabaseService {
+private:
+    shared_ptr<OutputSink> output;
+
 public:
+    explicit MySQLDatabase(shared_ptr<OutputSink> sink = defaultOutputSink())
+        : output(sink) {
+    }
+
     void save(const Order& order) override {
-        cout << " MySQL: Saving to MySQL database: " << order.toString() << endl;
+        writeOrderLine(*output, " MySQL: Saving to MySQL database: ", order);
+    }
+
+    void saveBatch(OrderSpan orders) override {
+        if (orders.empty()) {
+            return;
+        }
+        output->writeLine(" MySQL: " + buildMultiRowInsert(orders));
     }
 
     Order findById(int id) override {
-        return Order(id, "MySQL Order #" + to_string(id), 25.99);
+        return Order(id, "MySQL Order #" + to_string(id), Money(25, 99));
+    }
+
+    // Satu query IN (...) untuk seluruh batch
+    // (backend simulasi: semua id dianggap ada, jadi missing tidak pernah diisi)
+    void findByIds(IdSpan ids, vector<Order>& found, vector<int>&) override {
+        if (ids.empty()) {
+            return;
+        }
+        output->writeLine(" MySQL: SELECT id, description, amount FROM orders WHERE id IN (" + joinIds(ids) + ")");
+        for (int id : ids) {
+            found.push_back(findById(id));
+        }
     }
 
     string getType() const override { return "MySQL"; }
 };
 
 class PostgreSQLDatabase : public DatabaseService {
+private:
+    shared_ptr<OutputSink> output;
+
 public:
+    explicit PostgreSQLDatabase(shared_ptr<OutputSink> sink = defaultOutputSink())
+        : output(sink) {
+    }
+
     void save(const Order& order) override {
-        cout << " PostgreSQL: Saving to PostgreSQL database: " << order.toString() << endl;
+        writeOrderLine(*output, " PostgreSQL: Saving to PostgreSQL database: ", order);
+    }
+
+    void saveBatch(OrderSpan orders) override {
+        if (orders.empty()) {
+            return;
+        }
+        output->writeLine(" PostgreSQL: " + buildMultiRowInsert(orders));
     }
 
     Order findById(int id) override {
-        return Order(id, "PostgreSQL Order #" + to_string(id), 29.99);
+        return Order(id, "PostgreSQL Order #" + to_string(id), Money(29, 99));
+    }
+
+    // Satu query IN (...) untuk seluruh batch
+    // (backend simulasi: semua id dianggap ada, jadi missing tidak pernah diisi)
+    void findByIds(IdSpan ids, vector<Order>& found, vector<int>&) override {
+        if (ids.empty()) {
+            return;
+        }
+        output->writeLine(" PostgreSQL: SELECT id, description, amount FROM orders WHERE id IN (" + joinIds(ids) + ")");
+        for (int id : ids) {
+            found.push_back(findById(id));
+        }
     }
 
     string getType() const override { return "PostgreSQL"; }
 };
 
 class MongoDatabase : public DatabaseService {
+private:
+    shared_ptr<OutputSink> output;
+
 public:
+    explicit MongoDatabase(shared_ptr<OutputSink> sink = defaultOutputSink())
+        : output(sink) {
+    }
+
     void save(const Order& order) override {
-        cout << " MongoDB: Saving to MongoDB database: " << order.toString() << endl;
+        writeOrderLine(*output, " MongoDB: Saving to MongoDB database: ", order);
+    }
+
+    // Satu insertMany() untuk seluruh batch
+    void saveBatch(OrderSpan orders) override {
+        if (orders.empty()) {
+            return;
+        }
+
+        string documents;
+        documents.reserve(orders.size() * 64);
+        for (size_t i = 0; i < orders.size(); ++i) {
+            if (i > 0) {
+                documents += ", ";
+            }
+            documents += "{_id: " + to_string(orders[i].getId()) + ", description: \"";
+            for (char c : orders[i].getDescription()) {
+                if (c == '"' || c == '\\') {
+                    documents += '\\';
+                }
+                documents += c;
+            }
+            documents += "\", amount: " + orders[i].getTotalAmount().toString() + "}";
+        }
+        output->writeLine(" MongoDB: db.orders.insertMany([" + documents + "])");
     }
 
     Order findById(int id) override {
-        return Order(id, "MongoDB Order #" + to_string(id), 27.50);
+        return Order(id, "MongoDB Order #" + to_string(id), Money(27, 50));
+    }
+
+    // Satu query $in untuk seluruh batch
+    // (backend simulasi: semua id dianggap ada, jadi missing tidak pernah diisi)
+    void findByIds(IdSpan ids, vector<Order>& found, vector<int>&) override {
+        if (ids.empty()) {
+            return;
+        }
+        output->writeLine(" MongoDB: db.orders.find({_id: {$in: [" + joinIds(ids) + "]}})");
+        for (int id : ids) {
+            found.push_back(findById(id));
+        }
     }
 
     string getType() const override { return "MongoDB"; }
 };
 
 class EmailNotification : public NotificationService {
+private:
+    shared_ptr<OutputSink> output;
+
 public:
-    void send(const string& message) override {
-        cout << " Email: " << message << endl;
+    explicit EmailNotification(shared_ptr<OutputSink> sink = defaultOutputSink())
+        : output(sink) {
+    }
+
+    void send(string_view message) override {
+        output->writeLine(string(" Email: ").append(message));
     }
 
     string getType() const override { return "Email"; }
 };
 
 class SMSNotification : public NotificationService {
+private:
+    shared_ptr<OutputSink> output;
+
 public:
-    void send(const string& message) override {
-        cout << " SMS: " << message << endl;
+    explicit SMSNotification(shared_ptr<OutputSink> sink = defaultOutputSink())
+        : output(sink) {
+    }
+
+    void send(string_view message) override {
+        output->writeLine(string(" SMS: ").append(message));
     }
 
     string getType() const override { return "SMS"; }
 };
 
 class SlackNotification : public NotificationService {
+private:
+    shared_ptr<OutputSink> output;
+
 public:
-    void send(const string& message) override {
-        cout << " Slack: " << message << endl;
+    explicit SlackNotification(shared_ptr<OutputSink> sink = defaultOutputSink())
+        : output(sink) {
+    }
+
+    void send(string_view message) override {
+        output->writeLine(string(" Slack: ").append(message));
     }
 
     string getType() const override { return "Slack"; }
 };
 
-//  SOLUTION 1: DEPENDENCY INJECTION
-class GoodRestaurantService {
-private:
-    shared_ptr<DatabaseService> database;
-    shared_ptr<NotificationService> notification;
+// ==================== IN-MEMORY BACKEND ====================
 
-public:
-    // Constructor Injection - depend on abstractions!
-    GoodRestaurantService(shared_ptr<DatabaseService> db,
-        shared_ptr<NotificationService> notif)
-        : database(db), notification(notif) {
-        cout << " GoodRestaurantService: Created with "
-            << db->getType() << " + " << notif->getType() << endl;
-    }
+// Open-addressing hash index (robin-hood linear probing). Id disimpan inline di
+// slot, jadi satu lookup biasanya cukup satu cache line; Order ada di slab contiguous.
+class OrderIndex {
+private:
+    struct Slot {
+        int32_t id;
+        uint32_t slabIndex;
+        uint32_t distance; // Probe length + 1; 0 = slot kosong
+    };
 
-    void processOrder(const Order& order) {
-        database->save(order);
-        notification->send("Order " + to_string(order.getId()) + " processed successfully!");
-        cout << " Order processed with LOOSE COUPLING (DIP compliant)" << endl;
-    }
+    vector<Slot> slots;
+    size_t mask = 0;
+    size_t count = 0;
 
-    Order getOrder(int id) {
-        return database->findById(id);
+    static size_t hashId(int id) {
+        uint64_t value = static_cast<uint32_t>(id) * 0x9E3779B97F4A7C15ULL;
+        return static_cast<size_t>(value ^ (value >> 32));
     }
 
-    string getConfiguration() const {
-        return database->getType() + " + " + notification->getType();
+    void grow() {
+        vector<Slot> old = move(slots);
+        slots.assign(old.empty() ? 16 : old.size() * 2, Slot{ 0, 0, 0 });
+        mask = slots.size() - 1;
+        count = 0;
+        for (const Slot& slot : old) {
+            if (slot.distance != 0) {
+                insert(slot.id, slot.slabIndex);
+            }
+        }
     }
-};
 
-//  SOLUTION 2: FACTORY PATTERN
-class DatabaseFactory {
 public:
-    static shared_ptr<DatabaseService> createDatabase(const string& type) {
-        if (type == "mysql") {
-            return make_shared<MySQLDatabase>();
-        }
-        else if (type == "postgresql") {
-            return make_shared<PostgreSQLDatabase>();
+    // Return pointer ke slabIndex, atau nullptr kalau id tidak ada
+    const uint32_t* find(int id) const {
+        if (slots.empty()) {
+            return nullptr;
         }
-        else if (type == "mongodb") {
-            return make_shared<MongoDatabase>();
-        }
-        else {
-            throw invalid_argument("Unknown database type: " + type);
+        size_t position = hashId(id) & mask;
+        for (uint32_t distance = 1;; ++distance) {
+            const Slot& slot = slots[position];
+            if (slot.distance < distance) {
+                return nullptr; // Kosong, atau robin-hood invariant: id pasti tidak ada
+            }
+            if (slot.id == id) {
+                return &slot.slabIndex;
+            }
+            position = (position + 1) & mask;
         }
     }
-};
 
-class NotificationFactory {
-public:
-    static shared_ptr<NotificationService> createNotification(const string& type) {
-        if (type == "email") {
-            return make_shared<EmailNotification>();
-        }
-        else if (type == "sms") {
-            return make_shared<SMSNotification>();
+    // Hint ke CPU untuk memuat slot awal id (dipakai lookup batch)
+    void prefetch(int id) const {
+#if defined(__GNUC__) || defined(__clang__)
+        if (!slots.empty()) {
+            __builtin_prefetch(&slots[hashId(id) & mask]);
         }
-        else if (type == "slack") {
-            return make_shared<SlackNotification>();
+#else
+        (void)id;
+#endif
+    }
+
+    // Id harus belum ada di index
+    void insert(int id, uint32_t slabIndex) {
+        if ((count + 1) * 8 > slots.size() * 7) { // Load factor maksimal 7/8
+            grow();
         }
-        else {
-            throw invalid_argument("Unknown notification type: " + type);
+
+        Slot incoming{ id, slabIndex, 1 };
+        size_t position = hashId(id) & mask;
+        while (true) {
+            Slot& slot = slots[position];
+            if (slot.distance == 0) {
+                slot = incoming;
+                count++;
+                return;
+            }
+            if (slot.distance < incoming.distance) {
+                swap(slot, incoming); // Ambil dari yang "lebih kaya"
+            }
+            position = (position + 1) & mask;
+            incoming.distance++;
         }
     }
+
+    size_t size() const { return count; }
 };
 
-class RestaurantManager {
+// Backend in-memory: banyak reader bersamaan, satu writer (shared_mutex)
+class InMemoryDatabase : public DatabaseService {
 private:
-    shared_ptr<GoodRestaurantService> restaurantService;
+    mutable shared_mutex storeMutex;
+    OrderIndex index;
+    vector<Order> slab; // Orders contiguous; index menyimpan posisi di sini
 
 public:
-    void initialize(const string& dbType, const string& notificationType) {
-        cout << "  Initializing restaurant with " << dbType
-            << " and " << notificationType << endl;
-
-        auto database = DatabaseFactory::createDatabase(dbType);
-        auto notification = NotificationFactory::createNotification(notificationType);
-
-        restaurantService = make_shared<GoodRestaurantService>(database, notification);
+    void save(const Order& order) override {
+        unique_lock<shared_mutex> lock(storeMutex);
+        if (const uint32_t* existing = index.find(order.getId())) {
+            slab[*existing] = order;
+            return;
+        }
+        slab.push_back(order);
+        index.insert(order.getId(), static_cast<uint32_t>(slab.size() - 1));
     }
 
-    void processOrder(const Order& order) {
-        if (restaurantService) {
-            restaurantService->processOrder(order);
+    void saveBatch(OrderSpan orders) override {
+        unique_lock<shared_mutex> lock(storeMutex);
+        slab.reserve(slab.size() + orders.size());
+        for (const auto& order : orders) {
+            if (const uint32_t* existing = index.find(order.getId())) {
+                slab[*existing] = order;
+            }
+            else {
+                slab.push_back(order);
+                index.insert(order.getId(), static_cast<uint32_t>(slab.size() - 1));
+            }
         }
-        else {
-            cout << " Restaurant not initialized!" << endl;
+    }
+
+    Order findById(int id) override {
+        optional<Order> order = tryFind(id);
+        if (!order) {
+            throw out_of_range("Order not found: " + to_string(id));
         }
+        return move(*order);
     }
 
-    string getConfiguration() const {
-        return restaurantService ? restaurantService->getConfiguration() : "Not initialized";
+    // Seperti findById tanpa exception, untuk layer yang sering miss (overlay)
+    optional<Order> tryFind(int id) const {
+        shared_lock<shared_mutex> lock(storeMutex);
+        const uint32_t* position = index.find(id);
+        if (position == nullptr) {
+            return nullopt;
+        }
+        return slab[*position];
     }
-};
 
-//  SOLUTION 3: STRATEGY PATTERN
-class PaymentStrategy {
-public:
-    virtual ~PaymentStrategy() = default;
-    virtual void processPayment(double amount) = 0;
-    virtual bool validatePayment(const string& paymentInfo) = 0;
-    virtual string getPaymentType() const = 0;
-};
+    // Satu shared lock untuk seluruh batch; slot id berikutnya di-prefetch
+    // selagi id sekarang diproses, jadi cache miss saling tumpang tindih
+    void findByIds(IdSpan ids, vector<Order>& found, vector<int>& missing) override {
+        static constexpr size_t PREFETCH_DISTANCE = 8;
 
-class CreditCardStrategy : public PaymentStrategy {
-public:
-    void processPayment(double amount) override {
-        cout << " Processing credit card payment: $" << amount << endl;
+        shared_lock<shared_mutex> lock(storeMutex);
+        for (size_t i = 0; i < min(PREFETCH_DISTANCE, ids.size()); ++i) {
+            index.prefetch(ids[i]);
+        }
+        for (size_t i = 0; i < ids.size(); ++i) {
+            if (i + PREFETCH_DISTANCE < ids.size()) {
+                index.prefetch(ids[i + PREFETCH_DISTANCE]);
+            }
+            if (const uint32_t* position = index.find(ids[i])) {
+                found.push_back(slab[*position]);
+            }
+            else {
+                missing.push_back(ids[i]);
+            }
+        }
     }
 
-    bool validatePayment(const string& paymentInfo) override {
-        return paymentInfo.length() == 16; // Simple validation
+    size_t size() const {
+        shared_lock<shared_mutex> lock(storeMutex);
+        return slab.size();
     }
 
-    string getPaymentType() const override { return "Credit Card"; }
+    // Copy konsisten semua order (misal untuk OrderSnapshot::writeInBackground)
+    vector<Order> allOrders() const {
+        shared_lock<shared_mutex> lock(storeMutex);
+        return slab;
+    }
+
+    string getType() const override { return "InMemory"; }
 };
 
-class DigitalWalletStrategy : public PaymentStrategy {
-public:
-    void processPayment(double amount) override {
-        cout << " Processing digital wallet payment: $" << amount << endl;
-    }
+// ==================== PERSISTENT BACKENDS ====================
+// Storage lokal sungguhan (POSIX file I/O), bukan cuma print seperti backend di atas
 
-    bool validatePayment(const string& paymentInfo) override {
-        return !paymentInfo.empty(); // Simple validation
+// Binary record: [u32 payloadSize][i32 id][i64 cents][u32 descLen][u32 typeLen][u32 infoLen][bytes]
+// Encoding memakai byte order host (file tidak portable antar arsitektur).
+class OrderCodec {
+private:
+    template <typename T>
+    static void appendPod(string& out, T value) {
+        out.append(reinterpret_cast<const char*>(&value), sizeof(T));
     }
 
-    string getPaymentType() const override { return "Digital Wallet"; }
-};
+    template <typename T>
+    static T readPod(const char* data) {
+        T value;
+        memcpy(&value, data, sizeof(T));
+        return value;
+    }
 
-class CashStrategy : public PaymentStrategy {
 public:
-    void processPayment(double amount) override {
-        cout << " Processing cash payment: $" << amount << endl;
+    static constexpr size_t SIZE_PREFIX = sizeof(uint32_t);
+    static constexpr size_t FIXED_PAYLOAD = sizeof(int32_t) + sizeof(int64_t) + 3 * sizeof(uint32_t);
+
+    // Append satu record lengkap (termasuk size prefix) ke out
+    static void encode(const Order& order, string& out) {
+        string_view description = order.getDescription();
+        string_view paymentType = order.getPaymentType();
+        string_view paymentInfo = order.getPaymentInfo();
+        size_t payloadSize = FIXED_PAYLOAD + description.size() + paymentType.size() + paymentInfo.size();
+
+        out.reserve(out.size() + SIZE_PREFIX + payloadSize);
+        appendPod<uint32_t>(out, static_cast<uint32_t>(payloadSize));
+        appendPod<int32_t>(out, order.getId());
+        appendPod<int64_t>(out, order.getTotalAmount().getCents());
+        appendPod<uint32_t>(out, static_cast<uint32_t>(description.size()));
+        appendPod<uint32_t>(out, static_cast<uint32_t>(paymentType.size()));
+        appendPod<uint32_t>(out, static_cast<uint32_t>(paymentInfo.size()));
+        out.append(description);
+        out.append(paymentType);
+        out.append(paymentInfo);
     }
 
-    bool validatePayment(const string& paymentInfo) override {
-        return true; // Cash always valid
+    static uint32_t payloadSize(const char* prefix) {
+        return readPod<uint32_t>(prefix);
     }
 
-    string getPaymentType() const override { return "Cash"; }
+    static int32_t peekId(const char* payload) {
+        return readPod<int32_t>(payload);
+    }
+
+    // Decode payload (tanpa size prefix)
+    static Order decode(const char* payload, size_t size) {
+        if (size < FIXED_PAYLOAD) {
+            throw runtime_error("Corrupt order record: payload too small");
+        }
+        int32_t id = readPod<int32_t>(payload);
+        int64_t cents = readPod<int64_t>(payload + 4);
+        uint32_t descriptionSize = readPod<uint32_t>(payload + 12);
+        uint32_t typeSize = readPod<uint32_t>(payload + 16);
+        uint32_t infoSize = readPod<uint32_t>(payload + 20);
+        if (FIXED_PAYLOAD + uint64_t(descriptionSize) + typeSize + infoSize != size) {
+            throw runtime_error("Corrupt order record: field sizes do not match payload");
+        }
+
+        const char* text = payload + FIXED_PAYLOAD;
+        Order order(id, string(text, descriptionSize), Money::fromCents(cents));
+        if (typeSize > 0 || infoSize > 0) {
+            order.setPaymentInfo(string(text + descriptionSize, typeSize),
+                string(text + descriptionSize + typeSize, infoSize));
+        }
+        return order;
+    }
 };
 
-class PaymentProcessor {
+// RAII file descriptor + helper I/O yang melempar runtime_error saat gagal
+class FileHandle {
 private:
-    shared_ptr<PaymentStrategy> strategy;
+    int fd;
+    string path;
+
+    [[noreturn]] void fail(const string& operation) const {
+        throw runtime_error(operation + " failed for " + path + ": " + strerror(errno));
+    }
 
 public:
-    PaymentProcessor(shared_ptr<PaymentStrategy> strat) : strategy(strat) {
-        cout << " PaymentProcessor initialized with: " << strat->getPaymentType() << endl;
+    FileHandle(const string& filePath, int flags, mode_t mode = 0644)
+        : fd(::open(filePath.c_str(), flags, mode)), path(filePath) {
+        if (fd < 0) {
+            fail("open");
+        }
     }
 
-    void setStrategy(shared_ptr<PaymentStrategy> newStrategy) {
-        strategy = newStrategy;
-        cout << " Payment strategy changed to: " << strategy->getPaymentType() << endl;
+    ~FileHandle() {
+        ::close(fd);
     }
 
-    bool processOrderPayment(const Order& order) {
-        cout << " Processing payment for order: " << order.getId() << endl;
+    FileHandle(const FileHandle&) = delete;
+    FileHandle& operator=(const FileHandle&) = delete;
 
-        if (strategy->validatePayment(order.getPaymentInfo())) {
-            strategy->processPayment(order.getTotalAmount());
-            cout << " Payment successful!" << endl;
-            return true;
+    int get() const { return fd; }
+    const string& getPath() const { return path; }
+
+    uint64_t size() const {
+        struct stat info;
+        if (::fstat(fd, &info) != 0) {
+            fail("fstat");
         }
-        else {
-            cout << " Payment validation failed!" << endl;
-            return false;
+        return static_cast<uint64_t>(info.st_size);
+    }
+
+    void writeAt(const char* data, size_t length, uint64_t offset) {
+        while (length > 0) {
+            ssize_t written = ::pwrite(fd, data, length, static_cast<off_t>(offset));
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                fail("pwrite");
+            }
+            data += written;
+            length -= static_cast<size_t>(written);
+            offset += static_cast<uint64_t>(written);
         }
     }
 
-    string getCurrentStrategy() const {
-        return strategy->getPaymentType();
+    // Return jumlah byte yang terbaca (bisa kurang dari length di akhir file)
+    size_t readAt(char* data, size_t length, uint64_t offset) const {
+        size_t total = 0;
+        while (total < length) {
+            ssize_t count = ::pread(fd, data + total, length - total, static_cast<off_t>(offset + total));
+            if (count < 0) {
+                if (errno == EINTR) continue;
+                fail("pread");
+            }
+            if (count == 0) {
+                break;
+            }
+            total += static_cast<size_t>(count);
+        }
+        return total;
     }
-};
 
-// ==================== MOCK CLASSES FOR TESTING ====================
-class MockDatabase : public DatabaseService {
-public:
-    void save(const Order& order) override {
-        cout << " MOCK DATABASE: Save called for order " << order.getId() << endl;
+    // Rename file di disk dan path yang dilaporkan getPath(). Hanya boleh dipanggil
+    // selagi handle belum dibagi ke thread lain (path tidak dilindungi lock).
+    void renameTo(const string& newPath) {
+        if (::rename(path.c_str(), newPath.c_str()) != 0) {
+            fail("rename to " + newPath);
+        }
+        path = newPath;
     }
 
-    Order findById(int id) override {
-        return Order(id, "Mock Order", 0.0);
+    void truncate(uint64_t length) {
+        if (::ftruncate(fd, static_cast<off_t>(length)) != 0) {
+            fail("ftruncate");
+        }
     }
 
-    string getType() const override { return "Mock Database"; }
+    void sync() {
+        if (::fdatasync(fd) != 0) {
+            fail("fdatasync");
+        }
+    }
 };
 
-class MockNotification : public NotificationService {
-public:
-    void send(const string& message) override {
-        cout << " MOCK NOTIFICATION: " << message << endl;
-    }
+// fsync direktori tempat path berada, supaya hasil rename() ikut durable
+void syncDirectoryOf(const string& path) {
+    size_t slash = path.find_last_of('/');
+    string directory = slash == string::npos ? "." : (slash == 0 ? "/" : path.substr(0, slash));
+    FileHandle(directory, O_RDONLY).sync();
+}
 
-    string getType() const override { return "Mock Notification"; }
+struct CompactionStats {
+    uint64_t bytesBefore = 0;
+    uint64_t bytesAfter = 0;
+    uint64_t recordsCopied = 0;
+    chrono::milliseconds duration{ 0 };
+    chrono::microseconds lockHeld{ 0 }; // Lama logMutex dipegang di phase 3 (reader/writer tertahan)
 };
 
-// ==================== DEMO FUNCTIONS ====================
+// Append-only log: setiap save() menambah record di akhir segment file,
+// index in-memory id -> lokasi record, findById = satu pread.
+// Re-save id yang sama meninggalkan record mati; compact() menulis ulang record
+// hidup di background, checkpoint() menyimpan index supaya recovery cukup replay tail.
+class LogStructuredDatabase : public DatabaseService {
+private:
+    static constexpr char SEGMENT_MAGIC[8] = { 'O', 'R', 'D', 'L', 'O', 'G', '0', '1' };
+    static constexpr char CHECKPOINT_MAGIC[8] = { 'O', 'R', 'D', 'C', 'K', 'P', 'T', '1' };
+    static constexpr uint64_t SEGMENT_HEADER_SIZE = sizeof(SEGMENT_MAGIC) + sizeof(uint64_t);
+    static constexpr size_t COPY_CHUNK = 256 * 1024;
 
-void printSeparator(const string& title) {
-    cout << "\n" << string(60, '=') << endl;
-    cout << "  " << title << endl;
-    cout << string(60, '=') << endl;
-}
+    struct RecordLocation {
+        uint64_t offset; // Offset size prefix
+        uint32_t size;   // Size prefix + payload
+    };
 
-void printSubSeparator(const string& title) {
-    cout << "\n" << string(40, '-') << endl;
-    cout << "  " << title << endl;
-    cout << string(40, '-') << endl;
-}
+    struct CheckpointEntry {
+        int32_t id;
+        uint32_t size;
+        uint64_t offset;
+    };
 
-void demonstrateProblem() {
-    printSubSeparator(" PROBLEM: DIP Violation Example");
+    string segmentPath;
+    shared_ptr<FileHandle> segment;
+    uint64_t generation = 1;
+    mutable mutex logMutex; // Melindungi segment, index, writeOffset, liveBytes
+    unordered_map<int, RecordLocation> index;
+    uint64_t writeOffset = 0;
+    uint64_t liveBytes = 0;
 
-    cout << "Mari kita lihat kode yang melanggar DIP:" << endl;
-    cout << "- RestaurantService depend langsung ke MySQLDatabase" << endl;
-    cout << "- RestaurantService depend langsung ke EmailNotification" << endl;
-    cout << "- Hard coded dependencies di constructor" << endl << endl;
+    mutex maintenanceMutex; // Satu compaction/checkpoint pada satu waktu
 
-    BadRestaurantService badService;
-    Order order1(1, "Nasi Gudeg Special", 35.00);
-    badService.processOrder(order1);
+    string checkpointPath() const { return segmentPath + ".ckpt"; }
 
-    cout << "\n Masalah:" << endl;
-    cout << "   1. Sulit ganti database (MySQL ke PostgreSQL)" << endl;
-    cout << "   2. Sulit ganti notification (Email ke SMS)" << endl;
-    cout << "   3. Sulit testing (tidak bisa mock)" << endl;
-    cout << "   4. Tight coupling = maintenance nightmare!" << endl;
-}
+    static void writeHeader(FileHandle& file, uint64_t segmentGeneration) {
+        string header(SEGMENT_MAGIC, sizeof(SEGMENT_MAGIC));
+        header.append(reinterpret_cast<const char*>(&segmentGeneration), sizeof(segmentGeneration));
+        file.writeAt(header.data(), header.size(), 0);
+    }
 
-void demonstrateDependencyInjection() {
-    printSubSeparator(" SOLUTION 1: Dependency Injection");
+    // Scan record lengkap mulai dari offset; return offset setelah record terakhir
+    static uint64_t scanRecords(const FileHandle& file, uint64_t offset, uint64_t end,
+        unordered_map<int, RecordLocation>& target) {
+        string payload;
+        while (offset + OrderCodec::SIZE_PREFIX <= end) {
+            char prefix[OrderCodec::SIZE_PREFIX];
+            file.readAt(prefix, sizeof(prefix), offset);
+            uint32_t payloadSize = OrderCodec::payloadSize(prefix);
+            if (payloadSize < OrderCodec::FIXED_PAYLOAD ||
+                offset + OrderCodec::SIZE_PREFIX + payloadSize > end) {
+                break; // Record terakhir tidak lengkap (crash saat write)
+            }
 
-    cout << "Dependency Injection: Inject dependencies dari luar!" << endl;
-    cout << "- Depend on abstractions (interfaces)" << endl;
-    cout << "- Constructor injection" << endl;
-    cout << "- Loose coupling achieved!" << endl << endl;
+            payload.resize(payloadSize);
+            file.readAt(&payload[0], payloadSize, offset + OrderCodec::SIZE_PREFIX);
+            uint32_t recordSize = static_cast<uint32_t>(OrderCodec::SIZE_PREFIX + payloadSize);
+            target[OrderCodec::peekId(payload.data())] = RecordLocation{ offset, recordSize };
+            offset += recordSize;
+        }
+        return offset;
+    }
+
+    // Load index dari checkpoint kalau generation cocok; return offset yang sudah tercakup
+    uint64_t loadCheckpoint(uint64_t fileSize) {
+        try {
+            FileHandle file(checkpointPath(), O_RDONLY);
+            char header[sizeof(CHECKPOINT_MAGIC) + 3 * sizeof(uint64_t)];
+            if (file.readAt(header, sizeof(header), 0) != sizeof(header) ||
+                memcmp(header, CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC)) != 0) {
+                return 0;
+            }
+            uint64_t checkpointGeneration, coveredOffset, count;
+            memcpy(&checkpointGeneration, header + 8, sizeof(uint64_t));
+            memcpy(&coveredOffset, header + 16, sizeof(uint64_t));
+            memcpy(&count, header + 24, sizeof(uint64_t));
+            if (checkpointGeneration != generation || coveredOffset > fileSize) {
+                return 0; // Checkpoint milik segment lama (sebelum compaction)
+            }
+
+            // count dari file belum tentu benar: cek muat di sisa file sebelum alokasi
+            uint64_t checkpointSize = file.size();
+            if (count > (checkpointSize - sizeof(header)) / sizeof(CheckpointEntry)) {
+                throw runtime_error("Truncated checkpoint: " + checkpointPath());
+            }
+            vector<CheckpointEntry> entries(count);
+            size_t bytes = count * sizeof(CheckpointEntry);
+            if (file.readAt(reinterpret_cast<char*>(entries.data()), bytes, sizeof(header)) != bytes) {
+                return 0;
+            }
+            for (const auto& entry : entries) {
+                index[entry.id] = RecordLocation{ entry.offset, entry.size };
+            }
+            return coveredOffset;
+        }
+        catch (const runtime_error&) {
+            index.clear();
+            return 0; // Tidak ada checkpoint: full scan
+        }
+    }
+
+    // Recovery: checkpoint (kalau ada) + replay tail; tail yang terpotong dibuang
+    void recover() {
+        uint64_t fileSize = segment->size();
+        if (fileSize == 0) {
+            writeHeader(*segment, generation);
+            writeOffset = SEGMENT_HEADER_SIZE;
+            return;
+        }
+
+        char header[SEGMENT_HEADER_SIZE];
+        if (fileSize < SEGMENT_HEADER_SIZE ||
+            segment->readAt(header, sizeof(header), 0) != sizeof(header) ||
+            memcmp(header, SEGMENT_MAGIC, sizeof(SEGMENT_MAGIC)) != 0) {
+            throw runtime_error("Not an order log segment: " + segment->getPath());
+        }
+        memcpy(&generation, header + sizeof(SEGMENT_MAGIC), sizeof(generation));
+
+        uint64_t offset = max(loadCheckpoint(fileSize), SEGMENT_HEADER_SIZE);
+        offset = scanRecords(*segment, offset, fileSize, index);
+        if (offset != fileSize) {
+            segment->truncate(offset);
+        }
+        writeOffset = offset;
+        for (const auto& entry : index) {
+            liveBytes += entry.second.size;
+        }
+    }
+
+    void indexRecordLocked(int id, RecordLocation location) {
+        auto entry = index.find(id);
+        if (entry != index.end()) {
+            liveBytes -= entry->second.size; // Versi lama jadi record mati
+            entry->second = location;
+        }
+        else {
+            index.emplace(id, location);
+        }
+        liveBytes += location.size;
+    }
+
+    // Dipanggil dengan logMutex terkunci; buffer berisi record-record lengkap
+    void appendLocked(const string& records) {
+        segment->writeAt(records.data(), records.size(), writeOffset);
+
+        uint64_t offset = writeOffset;
+        while (offset < writeOffset + records.size()) {
+            const char* record = records.data() + (offset - writeOffset);
+            uint32_t recordSize = static_cast<uint32_t>(OrderCodec::SIZE_PREFIX + OrderCodec::payloadSize(record));
+            indexRecordLocked(OrderCodec::peekId(record + OrderCodec::SIZE_PREFIX), RecordLocation{ offset, recordSize });
+            offset += recordSize;
+        }
+        writeOffset = offset;
+    }
+
+    // Copy byte [from, to) dari source ke target di targetOffset, dibatasi bytesPerSecond
+    static void copyRange(const FileHandle& source, uint64_t from, uint64_t to,
+        FileHandle& target, uint64_t targetOffset, uint64_t bytesPerSecond) {
+        string chunk;
+        auto start = chrono::steady_clock::now();
+        uint64_t copied = 0;
+        while (from < to) {
+            chunk.resize(static_cast<size_t>(min<uint64_t>(COPY_CHUNK, to - from)));
+            if (source.readAt(&chunk[0], chunk.size(), from) != chunk.size()) {
+                throw runtime_error("Short read during compaction: " + source.getPath());
+            }
+            target.writeAt(chunk.data(), chunk.size(), targetOffset);
+            from += chunk.size();
+            targetOffset += chunk.size();
+            copied += chunk.size();
+            throttle(start, copied, bytesPerSecond);
+        }
+    }
+
+    // Sleep supaya rata-rata I/O tidak melewati bytesPerSecond (0 = tanpa batas)
+    static void throttle(chrono::steady_clock::time_point start, uint64_t bytes, uint64_t bytesPerSecond) {
+        if (bytesPerSecond == 0) {
+            return;
+        }
+        auto due = start + chrono::microseconds(bytes * 1000000 / bytesPerSecond);
+        this_thread::sleep_until(due);
+    }
+
+    void writeCheckpoint(uint64_t checkpointGeneration, uint64_t coveredOffset,
+        const vector<CheckpointEntry>& entries) {
+        string temporaryPath = checkpointPath() + ".tmp";
+        {
+            FileHandle file(temporaryPath, O_RDWR | O_CREAT | O_TRUNC);
+            uint64_t count = entries.size();
+            string header(CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+            header.append(reinterpret_cast<const char*>(&checkpointGeneration), sizeof(uint64_t));
+            header.append(reinterpret_cast<const char*>(&coveredOffset), sizeof(uint64_t));
+            header.append(reinterpret_cast<const char*>(&count), sizeof(uint64_t));
+            file.writeAt(header.data(), header.size(), 0);
+            file.writeAt(reinterpret_cast<const char*>(entries.data()),
+                entries.size() * sizeof(CheckpointEntry), header.size());
+            file.sync();
+        }
+        if (::rename(temporaryPath.c_str(), checkpointPath().c_str()) != 0) {
+            throw runtime_error("rename failed for " + temporaryPath + ": " + strerror(errno));
+        }
+        syncDirectoryOf(checkpointPath());
+    }
+
+    void checkpointUnlocked() {
+        shared_ptr<FileHandle> file;
+        uint64_t checkpointGeneration, coveredOffset;
+        vector<CheckpointEntry> entries;
+        {
+            lock_guard<mutex> lock(logMutex);
+            file = segment;
+            checkpointGeneration = generation;
+            coveredOffset = writeOffset;
+            entries.reserve(index.size());
+            for (const auto& entry : index) {
+                entries.push_back(CheckpointEntry{ entry.first, entry.second.size, entry.second.offset });
+            }
+        }
+        file->sync(); // Record yang dicakup checkpoint harus sudah durable
+        writeCheckpoint(checkpointGeneration, coveredOffset, entries);
+    }
+
+public:
+    explicit LogStructuredDatabase(const string& path)
+        : segmentPath(path), segment(make_shared<FileHandle>(path, O_RDWR | O_CREAT)) {
+        recover();
+    }
+
+    void save(const Order& order) override {
+        string record;
+        OrderCodec::encode(order, record);
+        lock_guard<mutex> lock(logMutex);
+        appendLocked(record);
+    }
+
+    // Satu pwrite untuk seluruh batch
+    void saveBatch(OrderSpan orders) override {
+        string records;
+        for (const auto& order : orders) {
+            OrderCodec::encode(order, records);
+        }
+        lock_guard<mutex> lock(logMutex);
+        appendLocked(records);
+    }
+
+    Order findById(int id) override {
+        RecordLocation location;
+        shared_ptr<FileHandle> file;
+        {
+            lock_guard<mutex> lock(logMutex);
+            auto entry = index.find(id);
+            if (entry == index.end()) {
+                throw out_of_range("Order not found: " + to_string(id));
+            }
+            location = entry->second;
+            file = segment;
+        }
+
+        // Satu positioned read tanpa memegang lock. Selama compaction, file lama
+        // tetap terbuka lewat shared_ptr sampai read terakhir selesai.
+        string record(location.size, '\0');
+        if (file->readAt(&record[0], record.size(), location.offset) != record.size()) {
+            throw runtime_error("Short read in order log: " + file->getPath());
+        }
+        return OrderCodec::decode(record.data() + OrderCodec::SIZE_PREFIX,
+            record.size() - OrderCodec::SIZE_PREFIX);
+    }
+
+    // Semua lokasi diambil dalam satu lock, lalu pread tanpa lock
+    void findByIds(IdSpan ids, vector<Order>& found, vector<int>& missing) override {
+        vector<RecordLocation> locations;
+        shared_ptr<FileHandle> file;
+        {
+            lock_guard<mutex> lock(logMutex);
+            file = segment;
+            for (int id : ids) {
+                auto entry = index.find(id);
+                if (entry == index.end()) {
+                    missing.push_back(id);
+                }
+                else {
+                    locations.push_back(entry->second);
+                }
+            }
+        }
+
+        string record;
+        for (const auto& location : locations) {
+            record.resize(location.size);
+            if (file->readAt(&record[0], record.size(), location.offset) != record.size()) {
+                throw runtime_error("Short read in order log: " + file->getPath());
+            }
+            found.push_back(OrderCodec::decode(record.data() + OrderCodec::SIZE_PREFIX,
+                record.size() - OrderCodec::SIZE_PREFIX));
+        }
+    }
+
+    // Tulis ulang record hidup ke segment baru dengan bandwidth I/O dibatasi
+    // (bytesPerSecond, 0 = tanpa batas). Reader dan writer tetap jalan; lock hanya
+    // dipegang sebentar untuk copy tail terakhir dan swap segment.
+    CompactionStats compact(uint64_t bytesPerSecond = 0) {
+        lock_guard<mutex> maintenance(maintenanceMutex);
+        auto started = chrono::steady_clock::now();
+        CompactionStats stats;
+
+        shared_ptr<FileHandle> source;
+        vector<pair<int, RecordLocation>> live;
+        uint64_t copiedUntil, newGeneration;
+        {
+            lock_guard<mutex> lock(logMutex);
+            source = segment;
+            copiedUntil = writeOffset;
+            newGeneration = generation + 1;
+            stats.bytesBefore = writeOffset;
+            live.assign(index.begin(), index.end());
+        }
+        // Urut berdasarkan offset: baca segment lama secara sequential
+        sort(live.begin(), live.end(), [](const pair<int, RecordLocation>& a, const pair<int, RecordLocation>& b) {
+            return a.second.offset < b.second.offset;
+        });
+
+        string compactPath = segmentPath + ".compact";
+        auto target = make_shared<FileHandle>(compactPath, O_RDWR | O_CREAT | O_TRUNC);
+        bool renamed = false;
+        try {
+            writeHeader(*target, newGeneration);
+
+            // Phase 1: copy record hidup per chunk, di-throttle
+            unordered_map<int, RecordLocation> newIndex;
+            uint64_t targetOffset = SEGMENT_HEADER_SIZE;
+            string buffer, record;
+            auto throttleStart = chrono::steady_clock::now();
+            uint64_t throttledBytes = 0;
+            for (size_t i = 0; i < live.size(); ++i) {
+                const RecordLocation& location = live[i].second;
+                record.resize(location.size);
+                if (source->readAt(&record[0], record.size(), location.offset) != record.size()) {
+                    throw runtime_error("Short read during compaction: " + source->getPath());
+                }
+                newIndex[live[i].first] = RecordLocation{ targetOffset + buffer.size(), location.size };
+                buffer += record;
+
+                if (buffer.size() >= COPY_CHUNK || i + 1 == live.size()) {
+                    target->writeAt(buffer.data(), buffer.size(), targetOffset);
+                    targetOffset += buffer.size();
+                    throttledBytes += buffer.size();
+                    buffer.clear();
+                    throttle(throttleStart, throttledBytes, bytesPerSecond);
+                }
+            }
+            stats.recordsCopied = live.size();
+
+            // Phase 2: kejar tail yang ditulis selama phase 1, tanpa lock
+            while (true) {
+                uint64_t tailEnd;
+                {
+                    lock_guard<mutex> lock(logMutex);
+                    tailEnd = writeOffset;
+                }
+                if (tailEnd - copiedUntil <= COPY_CHUNK) {
+                    break;
+                }
+                uint64_t tailStart = targetOffset;
+                copyRange(*source, copiedUntil, tailEnd, *target, targetOffset, bytesPerSecond);
+                targetOffset += tailEnd - copiedUntil;
+                scanRecords(*target, tailStart, targetOffset, newIndex);
+                copiedUntil = tailEnd;
+            }
+
+            // Data phase 1/2 di-sync tanpa lock; di phase 3 hanya tail terakhir yang masih dirty
+            target->sync();
+
+            // Phase 3: tail terakhir + swap, di bawah lock (singkat)
+            {
+                lock_guard<mutex> lock(logMutex);
+                auto lockedAt = chrono::steady_clock::now();
+                uint64_t tailStart = targetOffset;
+                copyRange(*source, copiedUntil, writeOffset, *target, targetOffset, 0);
+                targetOffset += writeOffset - copiedUntil;
+                scanRecords(*target, tailStart, targetOffset, newIndex);
+
+                target->sync();
+                target->renameTo(segmentPath); // Error berikutnya menyebut path segment yang benar
+                renamed = true;
+                segment = target;
+                generation = newGeneration;
+                index = move(newIndex);
+                writeOffset = targetOffset;
+                liveBytes = 0;
+                for (const auto& entry : index) {
+                    liveBytes += entry.second.size;
+                }
+                stats.bytesAfter = writeOffset;
+                stats.lockHeld = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - lockedAt);
+            }
+        }
+        catch (...) {
+            if (!renamed) {
+                ::unlink(compactPath.c_str()); // Jangan tinggalkan segment setengah jadi
+            }
+            throw;
+        }
+        syncDirectoryOf(segmentPath);
+
+        // Checkpoint lama milik generation sebelumnya; langsung buat yang baru
+        checkpointUnlocked();
+        stats.duration = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - started);
+        return stats;
+    }
+
+    future<CompactionStats> compactInBackground(uint64_t bytesPerSecond = 0) {
+        return async(launch::async, [this, bytesPerSecond] { return compact(bytesPerSecond); });
+    }
+
+    // Simpan index + offset yang tercakup; recovery berikutnya hanya replay tail
+    void checkpoint() {
+        lock_guard<mutex> maintenance(maintenanceMutex);
+        checkpointUnlocked();
+    }
+
+    // fdatasync segment file
+    void sync() {
+        shared_ptr<FileHandle> file;
+        {
+            lock_guard<mutex> lock(logMutex);
+            file = segment;
+        }
+        file->sync();
+    }
+
+    size_t size() const {
+        lock_guard<mutex> lock(logMutex);
+        return index.size();
+    }
+
+    // Byte milik record yang sudah tergantikan - dasar keputusan kapan compact()
+    uint64_t getDeadBytes() const {
+        lock_guard<mutex> lock(logMutex);
+        return writeOffset - SEGMENT_HEADER_SIZE - liveBytes;
+    }
+
+    uint64_t getLiveBytes() const {
+        lock_guard<mutex> lock(logMutex);
+        return liveBytes;
+    }
+
+    string getType() const override { return "LogStructured"; }
+};
+
+enum class DurabilityPolicy {
+    None,      // Write ke OS tanpa fsync (cepat, bisa hilang saat crash)
+    Group,     // Group commit: satu fdatasync untuk semua writer yang menunggu
+    EveryWrite // Satu fdatasync per append
+};
+
+struct WalStats {
+    uint64_t appends = 0;
+    uint64_t syncs = 0;
+    uint64_t bytesWritten = 0;
+};
+
+// Write-ahead log dengan group commit. Writer yang bersamaan menumpuk record di
+// buffer bersama; satu writer jadi leader, menulis + fdatasync sekali untuk semua,
+// lalu semua writer dalam group dilepas begitu record mereka durable.
+class WriteAheadLog {
+private:
+    static constexpr char WAL_MAGIC[8] = { 'O', 'R', 'D', 'W', 'A', 'L', '0', '1' };
+
+    FileHandle file;
+    DurabilityPolicy policy;
+
+    mutex walMutex;
+    condition_variable groupDone;
+    string pending;          // Record yang belum ditulis (policy Group)
+    uint64_t appendedLsn = 0; // Log sequence number append terakhir
+    uint64_t durableLsn = 0;  // Semua LSN <= ini sudah durable
+    uint64_t writeOffset = 0;
+    bool leaderActive = false;
+    string failure;          // Error I/O terakhir; WAL berhenti menerima write
+    WalStats stats;
+
+    void recover() {
+        uint64_t fileSize = file.size();
+        if (fileSize == 0) {
+            file.writeAt(WAL_MAGIC, sizeof(WAL_MAGIC), 0);
+            writeOffset = sizeof(WAL_MAGIC);
+            return;
+        }
+
+        char magic[sizeof(WAL_MAGIC)];
+        if (file.readAt(magic, sizeof(magic), 0) != sizeof(magic) ||
+            memcmp(magic, WAL_MAGIC, sizeof(WAL_MAGIC)) != 0) {
+            throw runtime_error("Not a write-ahead log: " + file.getPath());
+        }
+
+        // Cari akhir record lengkap terakhir; tail yang terpotong dibuang
+        uint64_t offset = sizeof(WAL_MAGIC);
+        while (offset + OrderCodec::SIZE_PREFIX <= fileSize) {
+            char prefix[OrderCodec::SIZE_PREFIX];
+            file.readAt(prefix, sizeof(prefix), offset);
+            uint64_t recordSize = OrderCodec::SIZE_PREFIX + OrderCodec::payloadSize(prefix);
+            if (OrderCodec::payloadSize(prefix) < OrderCodec::FIXED_PAYLOAD || offset + recordSize > fileSize) {
+                break;
+            }
+            offset += recordSize;
+        }
+        if (offset != fileSize) {
+            file.truncate(offset);
+        }
+        writeOffset = offset;
+    }
+
+    void throwIfFailed() const {
+        if (!failure.empty()) {
+            throw runtime_error("Write-ahead log unavailable: " + failure);
+        }
+    }
+
+public:
+    WriteAheadLog(const string& path, DurabilityPolicy durability = DurabilityPolicy::Group)
+        : file(path, O_RDWR | O_CREAT), policy(durability) {
+        recover();
+    }
+
+    // Return setelah records durable sesuai policy. records = hasil OrderCodec::encode
+    void append(const string& records) {
+        unique_lock<mutex> lock(walMutex);
+        throwIfFailed();
+        stats.appends++;
+
+        if (policy != DurabilityPolicy::Group) {
+            try {
+                file.writeAt(records.data(), records.size(), writeOffset);
+                if (policy == DurabilityPolicy::EveryWrite) {
+                    file.sync();
+                    stats.syncs++;
+                }
+            }
+            catch (const exception& error) {
+                failure = error.what();
+                throw;
+            }
+            writeOffset += records.size();
+            stats.bytesWritten += records.size();
+            return;
+        }
+
+        pending += records;
+        uint64_t myLsn = ++appendedLsn;
+
+        while (durableLsn < myLsn) {
+            throwIfFailed();
+            if (leaderActive) {
+                groupDone.wait(lock); // Follower: tunggu leader selesai fsync
+                continue;
+            }
+
+            // Leader: ambil semua record yang terkumpul sejauh ini
+            leaderActive = true;
+            string group;
+            group.swap(pending);
+            uint64_t groupLsn = appendedLsn;
+            uint64_t offset = writeOffset;
+            lock.unlock();
+
+            string error;
+            try {
+                file.writeAt(group.data(), group.size(), offset);
+                file.sync();
+            }
+            catch (const exception& ioError) {
+                error = ioError.what();
+            }
+
+            lock.lock();
+            leaderActive = false;
+            if (!error.empty()) {
+                failure = error;
+                groupDone.notify_all();
+                throwIfFailed();
+            }
+            writeOffset = offset + group.size();
+            durableLsn = groupLsn;
+            stats.syncs++;
+            stats.bytesWritten += group.size();
+            groupDone.notify_all();
+        }
+    }
+
+    // Baca ulang semua record (misal untuk recovery backend setelah crash)
+    void replay(const function<void(const Order&)>& visit) {
+        lock_guard<mutex> lock(walMutex);
+        uint64_t offset = sizeof(WAL_MAGIC);
+        string payload;
+        while (offset < writeOffset) {
+            char prefix[OrderCodec::SIZE_PREFIX];
+            file.readAt(prefix, sizeof(prefix), offset);
+            payload.resize(OrderCodec::payloadSize(prefix));
+            file.readAt(&payload[0], payload.size(), offset + OrderCodec::SIZE_PREFIX);
+            visit(OrderCodec::decode(payload.data(), payload.size()));
+            offset += OrderCodec::SIZE_PREFIX + payload.size();
+        }
+    }
+
+    // Kosongkan log setelah backend sudah menyimpan semua record secara durable
+    void reset() {
+        lock_guard<mutex> lock(walMutex);
+        if (leaderActive || !pending.empty()) {
+            throw logic_error("Cannot reset write-ahead log while a group commit is in progress");
+        }
+        file.truncate(sizeof(WAL_MAGIC));
+        file.sync();
+        writeOffset = sizeof(WAL_MAGIC);
+    }
+
+    WalStats getStats() {
+        lock_guard<mutex> lock(walMutex);
+        return stats;
+    }
+
+    DurabilityPolicy getPolicy() const { return policy; }
+};
+
+// Snapshot file: [SnapshotHeader][SnapshotIndexEntry x count, sorted by id][records].
+// Index dan header bisa dipakai langsung dari mmap tanpa deserialisasi; record
+// (format OrderCodec) baru di-decode saat findById.
+struct SnapshotHeader {
+    char magic[8];
+    uint64_t count;
+    uint64_t indexOffset;
+    uint64_t recordsOffset;
+};
+
+struct SnapshotIndexEntry {
+    int32_t id;
+    uint32_t size;   // Size prefix + payload
+    uint64_t offset; // Offset record dari awal file
+};
+
+static_assert(sizeof(SnapshotHeader) == 32, "SnapshotHeader must be packed");
+static_assert(sizeof(SnapshotIndexEntry) == 16, "SnapshotIndexEntry must be packed");
+
+class OrderSnapshot {
+public:
+    static constexpr char SNAPSHOT_MAGIC[8] = { 'O', 'R', 'D', 'S', 'N', 'A', 'P', '1' };
+
+    // Tulis ke file sementara, fsync, lalu rename - snapshot lama tetap utuh kalau crash.
+    // Nama file sementara unik per proses + panggilan, jadi write bersamaan ke path
+    // yang sama tidak saling menimpa; rename yang selesai terakhir yang menang.
+    static void write(const string& path, vector<Order> orders) {
+        // Id ganda: yang terakhir menang
+        stable_sort(orders.begin(), orders.end(),
+            [](const Order& a, const Order& b) { return a.getId() < b.getId(); });
+        vector<const Order*> unique;
+        for (size_t i = 0; i < orders.size(); ++i) {
+            if (i + 1 < orders.size() && orders[i + 1].getId() == orders[i].getId()) {
+                continue;
+            }
+            unique.push_back(&orders[i]);
+        }
+
+        SnapshotHeader header;
+        memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+        header.count = unique.size();
+        header.indexOffset = sizeof(SnapshotHeader);
+        header.recordsOffset = header.indexOffset + unique.size() * sizeof(SnapshotIndexEntry);
+
+        vector<SnapshotIndexEntry> index;
+        index.reserve(unique.size());
+        string records;
+        for (const Order* order : unique) {
+            size_t before = records.size();
+            OrderCodec::encode(*order, records);
+            index.push_back(SnapshotIndexEntry{ order->getId(),
+                static_cast<uint32_t>(records.size() - before), header.recordsOffset + before });
+        }
+
+        static atomic<uint64_t> writeCounter{ 0 };
+        string temporaryPath = path + ".tmp." + to_string(::getpid()) + "." + to_string(writeCounter++);
+        try {
+            {
+                FileHandle file(temporaryPath, O_RDWR | O_CREAT | O_EXCL);
+                file.writeAt(reinterpret_cast<const char*>(&header), sizeof(header), 0);
+                file.writeAt(reinterpret_cast<const char*>(index.data()),
+                    index.size() * sizeof(SnapshotIndexEntry), header.indexOffset);
+                file.writeAt(records.data(), records.size(), header.recordsOffset);
+                file.sync();
+            }
+            if (::rename(temporaryPath.c_str(), path.c_str()) != 0) {
+                throw runtime_error("rename failed for " + temporaryPath + ": " + strerror(errno));
+            }
+        }
+        catch (const runtime_error&) {
+            ::unlink(temporaryPath.c_str()); // Jangan tinggalkan file sementara yatim
+            throw;
+        }
+    }
+
+    // Snapshot ditulis di background thread; orders sudah di-copy, jadi caller bebas lanjut
+    static future<void> writeInBackground(const string& path, vector<Order> orders) {
+        return async(launch::async, [path, orders = move(orders)]() mutable {
+            write(path, move(orders));
+        });
+    }
+};
+
+// Backend read-mostly di atas snapshot yang di-mmap: siap melayani findById begitu
+// file terbuka. Write setelah startup disimpan di overlay InMemoryDatabase.
+class MappedSnapshotDatabase : public DatabaseService {
+private:
+    const char* base = nullptr;
+    size_t mappedSize = 0;
+    const SnapshotIndexEntry* index = nullptr;
+    size_t count = 0;
+    InMemoryDatabase overlay;
+
+    const SnapshotIndexEntry* lookup(int id) const {
+        auto entry = lower_bound(index, index + count, id,
+            [](const SnapshotIndexEntry& e, int value) { return e.id < value; });
+        return entry != index + count && entry->id == id ? entry : nullptr;
+    }
+
+    // Record harus utuh di dalam area records: [recordsOffset, fileSize).
+    // Dibandingkan lewat pengurangan supaya offset + size tidak bisa overflow.
+    static bool recordInBounds(const SnapshotIndexEntry& entry, uint64_t recordsOffset, size_t fileSize) {
+        uint64_t recordsSize = fileSize - recordsOffset;
+        return entry.size >= OrderCodec::SIZE_PREFIX && entry.size <= recordsSize &&
+            entry.offset >= recordsOffset && entry.offset - recordsOffset <= recordsSize - entry.size;
+    }
+
+    // Entry sudah divalidasi saat open, jadi record selalu di dalam mapping
+    Order decode(const SnapshotIndexEntry& entry) const {
+        return OrderCodec::decode(base + entry.offset + OrderCodec::SIZE_PREFIX,
+            entry.size - OrderCodec::SIZE_PREFIX);
+    }
+
+public:
+    explicit MappedSnapshotDatabase(const string& path) {
+        FileHandle file(path, O_RDONLY);
+        mappedSize = file.size();
+        if (mappedSize < sizeof(SnapshotHeader)) {
+            throw runtime_error("Snapshot too small: " + path);
+        }
+
+        void* mapping = ::mmap(nullptr, mappedSize, PROT_READ, MAP_SHARED, file.get(), 0);
+        if (mapping == MAP_FAILED) {
+            throw runtime_error("mmap failed for " + path + ": " + strerror(errno));
+        }
+        base = static_cast<const char*>(mapping);
+
+        auto reject = [&](const string& reason) {
+            ::munmap(const_cast<char*>(base), mappedSize);
+            throw runtime_error("Corrupt order snapshot " + path + ": " + reason);
+        };
+
+        // Semua batas dicek sebelum dipakai; perbandingan disusun supaya tidak overflow
+        const auto* header = reinterpret_cast<const SnapshotHeader*>(base);
+        if (memcmp(header->magic, OrderSnapshot::SNAPSHOT_MAGIC, sizeof(header->magic)) != 0) {
+            reject("bad magic");
+        }
+        if (header->indexOffset < sizeof(SnapshotHeader) || header->indexOffset > mappedSize ||
+            header->indexOffset % alignof(SnapshotIndexEntry) != 0) {
+            reject("index offset out of range");
+        }
+        if (header->count > (mappedSize - header->indexOffset) / sizeof(SnapshotIndexEntry)) {
+            reject("index larger than file");
+        }
+        uint64_t indexEnd = header->indexOffset + header->count * sizeof(SnapshotIndexEntry);
+        if (header->recordsOffset < indexEnd || header->recordsOffset > mappedSize) {
+            reject("records offset out of range");
+        }
+
+        const auto* entries = reinterpret_cast<const SnapshotIndexEntry*>(base + header->indexOffset);
+        for (uint64_t i = 0; i < header->count; ++i) {
+            if (!recordInBounds(entries[i], header->recordsOffset, mappedSize)) {
+                reject("record for id " + to_string(entries[i].id) + " out of range");
+            }
+        }
+        index = entries;
+        count = header->count;
+        // File descriptor boleh ditutup; mapping tetap valid
+    }
+
+    ~MappedSnapshotDatabase() override {
+        ::munmap(const_cast<char*>(base), mappedSize);
+    }
+
+    MappedSnapshotDatabase(const MappedSnapshotDatabase&) = delete;
+    MappedSnapshotDatabase& operator=(const MappedSnapshotDatabase&) = delete;
+
+    void save(const Order& order) override {
+        overlay.save(order);
+    }
+
+    void saveBatch(OrderSpan orders) override {
+        overlay.saveBatch(orders);
+    }
+
+    Order findById(int id) override {
+        if (optional<Order> changed = overlay.tryFind(id)) {
+            return move(*changed);
+        }
+
+        // Belum diubah sejak startup: baca dari snapshot
+        const SnapshotIndexEntry* entry = lookup(id);
+        if (entry == nullptr) {
+            throw out_of_range("Order not found: " + to_string(id));
+        }
+        return decode(*entry);
+    }
+
+    // Gabungan snapshot + overlay, untuk menulis snapshot berikutnya
+    vector<Order> allOrders() {
+        vector<Order> orders;
+        orders.reserve(count + overlay.size());
+        for (size_t i = 0; i < count; ++i) {
+            optional<Order> changed = overlay.tryFind(index[i].id);
+            orders.push_back(changed ? move(*changed) : decode(index[i]));
+        }
+        for (Order& order : overlay.allOrders()) {
+            if (lookup(order.getId()) == nullptr) {
+                orders.push_back(move(order));
+            }
+        }
+        return orders;
+    }
+
+    size_t getSnapshotSize() const { return count; }
+
+    string getType() const override { return "MappedSnapshot"; }
+};
+
+// ==================== DECORATORS ====================
+// Decorator juga implement interface yang sama, jadi bisa di-inject tanpa ubah client
+
+struct AsyncNotificationStats {
+    uint64_t enqueued = 0;
+    uint64_t dispatched = 0;
+    uint64_t failed = 0;
+    uint64_t blockedSends = 0; // send() yang harus menunggu karena queue penuh
+    size_t queueDepth = 0;
+    size_t maxQueueDepth = 0;
+};
+
+// Async decorator: send() hanya enqueue, worker thread yang memanggil inner->send()
+class AsyncNotification : public NotificationService {
+private:
+    shared_ptr<NotificationService> inner;
+    size_t capacity;
+
+    deque<string> queue;
+    mutable mutex queueMutex;
+    condition_variable notEmpty;
+    condition_variable notFull;
+    vector<thread> workers;
+    bool stopping = false;
+    AsyncNotificationStats stats;
+
+    void workerLoop() {
+        while (true) {
+            string message;
+            {
+                unique_lock<mutex> lock(queueMutex);
+                notEmpty.wait(lock, [this] { return stopping || !queue.empty(); });
+                if (queue.empty()) {
+                    return; // Stopping dan queue sudah kosong (drained)
+                }
+                message = move(queue.front());
+                queue.pop_front();
+            }
+            notFull.notify_one();
+
+            bool delivered = true;
+            try {
+                inner->send(message);
+            }
+            catch (const exception&) {
+                delivered = false;
+            }
+
+            lock_guard<mutex> lock(queueMutex);
+            if (delivered) {
+                stats.dispatched++;
+            }
+            else {
+                stats.failed++;
+            }
+        }
+    }
+
+public:
+    AsyncNotification(shared_ptr<NotificationService> notif,
+        size_t workerCount = 1, size_t queueCapacity = 1024)
+        : inner(notif), capacity(queueCapacity) {
+        if (workerCount == 0 || queueCapacity == 0) {
+            throw invalid_argument("AsyncNotification needs at least one worker and queue slot");
+        }
+        for (size_t i = 0; i < workerCount; ++i) {
+            workers.emplace_back(&AsyncNotification::workerLoop, this);
+        }
+    }
+
+    ~AsyncNotification() override {
+        shutdown();
+    }
+
+    // Bounded queue: kalau penuh, producer menunggu (backpressure)
+    void send(string_view message) override {
+        unique_lock<mutex> lock(queueMutex);
+        if (stopping) {
+            lock.unlock();
+            inner->send(message); // Sudah shutdown: kirim langsung, jangan hilang
+            return;
+        }
+        if (queue.size() >= capacity) {
+            stats.blockedSends++;
+            notFull.wait(lock, [this] { return stopping || queue.size() < capacity; });
+            if (stopping) {
+                lock.unlock();
+                inner->send(message); // Shutdown saat menunggu: worker mungkin sudah selesai
+                return;
+            }
+        }
+        queue.emplace_back(message);
+        stats.enqueued++;
+        stats.maxQueueDepth = max(stats.maxQueueDepth, queue.size());
+        lock.unlock();
+        notEmpty.notify_one();
+    }
+
+    // Drain-on-shutdown: worker menyelesaikan semua pesan sebelum berhenti
+    void shutdown() {
+        {
+            lock_guard<mutex> lock(queueMutex);
+            if (stopping) {
+                return;
+            }
+            stopping = true;
+        }
+        notEmpty.notify_all();
+        notFull.notify_all(); // Producer yang menunggu slot kirim langsung
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    AsyncNotificationStats getStats() const {
+        lock_guard<mutex> lock(queueMutex);
+        AsyncNotificationStats snapshot = stats;
+        snapshot.queueDepth = queue.size();
+        return snapshot;
+    }
+
+    string getType() const override { return "Async " + inner->getType(); }
+};
+
+enum class FlushReason { Count, Bytes, Deadline, Explicit };
+
+struct BatchingStats {
+    static constexpr size_t HISTOGRAM_BUCKETS = 8;
+
+    uint64_t messages = 0;
+    uint64_t batches = 0;
+    uint64_t failedBatches = 0;
+    uint64_t flushesByCount = 0;
+    uint64_t flushesByBytes = 0;
+    uint64_t flushesByDeadline = 0;
+    uint64_t flushesByExplicit = 0; // flush() atau shutdown
+    // Bucket i: batch berisi [2^i, 2^(i+1)) pesan; bucket terakhir terbuka ke atas
+    array<uint64_t, HISTOGRAM_BUCKETS> batchSizeHistogram{};
+};
+
+// Batching decorator untuk satu channel: pesan dikumpulkan lalu dikirim sebagai
+// satu digest (dipisah '\n') saat jumlah, ukuran byte, atau deadline tercapai.
+// Pengiriman ke provider dilakukan oleh satu flusher thread, urutan tetap terjaga.
+class BatchingNotification : public NotificationService {
+private:
+    struct Entry {
+        string message;
+        chrono::steady_clock::time_point enqueuedAt;
+    };
+
+    shared_ptr<NotificationService> inner;
+    size_t maxMessages;
+    size_t maxBytes;
+    chrono::milliseconds maxDelay;
+
+    mutable mutex batchMutex;
+    condition_variable wakeup;
+    condition_variable flushed;
+    deque<Entry> pending;
+    size_t pendingBytes = 0;
+    size_t flushWaiters = 0;
+    bool inFlight = false;
+    bool stopping = false;
+    BatchingStats stats;
+    thread flusher;
+
+    // Dipanggil dengan batchMutex terkunci
+    optional<FlushReason> readyReason(chrono::steady_clock::time_point now) const {
+        if (pending.size() >= maxMessages) {
+            return FlushReason::Count;
+        }
+        if (pendingBytes >= maxBytes) {
+            return FlushReason::Bytes;
+        }
+        if (now >= pending.front().enqueuedAt + maxDelay) {
+            return FlushReason::Deadline;
+        }
+        if (stopping || flushWaiters > 0) {
+            return FlushReason::Explicit;
+        }
+        return nullopt;
+    }
+
+    void recordFlushLocked(FlushReason reason, size_t batchSize, bool delivered) {
+        switch (reason) {
+        case FlushReason::Count: stats.flushesByCount++; break;
+        case FlushReason::Bytes: stats.flushesByBytes++; break;
+        case FlushReason::Deadline: stats.flushesByDeadline++; break;
+        case FlushReason::Explicit: stats.flushesByExplicit++; break;
+        }
+        size_t bucket = 0;
+        while (bucket + 1 < BatchingStats::HISTOGRAM_BUCKETS && (batchSize >> (bucket + 1)) != 0) {
+            bucket++;
+        }
+        stats.batchSizeHistogram[bucket]++;
+        stats.batches++;
+        if (!delivered) {
+            stats.failedBatches++;
+        }
+    }
+
+    void flushLoop() {
+        string digest;
+        unique_lock<mutex> lock(batchMutex);
+        while (true) {
+            if (pending.empty()) {
+                flushed.notify_all();
+                if (stopping) {
+                    return; // Sudah drained
+                }
+                wakeup.wait(lock, [this] { return stopping || !pending.empty(); });
+                continue;
+            }
+
+            optional<FlushReason> reason = readyReason(chrono::steady_clock::now());
+            if (!reason) {
+                wakeup.wait_until(lock, pending.front().enqueuedAt + maxDelay);
+                continue;
+            }
+
+            // Ambil satu batch yang tidak melewati maxMessages / maxBytes
+            digest.clear();
+            size_t batchSize = 0;
+            while (!pending.empty() && batchSize < maxMessages &&
+                (batchSize == 0 || digest.size() + 1 + pending.front().message.size() <= maxBytes)) {
+                if (batchSize > 0) {
+                    digest += '\n';
+                }
+                digest += pending.front().message;
+                pendingBytes -= pending.front().message.size();
+                pending.pop_front();
+                batchSize++;
+            }
+            inFlight = true;
+            lock.unlock();
+
+            bool delivered = true;
+            try {
+                inner->send(digest);
+            }
+            catch (const exception&) {
+                delivered = false;
+            }
+
+            lock.lock();
+            inFlight = false;
+            recordFlushLocked(*reason, batchSize, delivered);
+        }
+    }
+
+public:
+    BatchingNotification(shared_ptr<NotificationService> notif, size_t maxBatchMessages = 32,
+        size_t maxBatchBytes = 4096, chrono::milliseconds maxBatchDelay = chrono::milliseconds(200))
+        : inner(notif), maxMessages(maxBatchMessages), maxBytes(maxBatchBytes), maxDelay(maxBatchDelay) {
+        if (maxBatchMessages == 0 || maxBatchBytes == 0) {
+            throw invalid_argument("BatchingNotification needs a positive message and byte limit");
+        }
+        flusher = thread(&BatchingNotification::flushLoop, this);
+    }
+
+    ~BatchingNotification() override {
+        shutdown();
+    }
+
+    void send(string_view message) override {
+        unique_lock<mutex> lock(batchMutex);
+        if (stopping) {
+            lock.unlock();
+            inner->send(message); // Sudah shutdown: kirim langsung, jangan hilang
+            return;
+        }
+        pending.push_back(Entry{ string(message), chrono::steady_clock::now() });
+        pendingBytes += message.size();
+        stats.messages++;
+        // Flusher hanya perlu dibangunkan untuk deadline baru atau batas yang tercapai
+        bool wake = pending.size() == 1 || pending.size() >= maxMessages || pendingBytes >= maxBytes;
+        lock.unlock();
+        if (wake) {
+            wakeup.notify_one();
+        }
+    }
+
+    // Kirim semua pesan yang tertunda dan tunggu sampai selesai
+    void flush() {
+        unique_lock<mutex> lock(batchMutex);
+        flushWaiters++;
+        wakeup.notify_one();
+        flushed.wait(lock, [this] { return pending.empty() && !inFlight; });
+        flushWaiters--;
+    }
+
+    // Drain-on-shutdown: pesan tertunda tetap dikirim
+    void shutdown() {
+        {
+            lock_guard<mutex> lock(batchMutex);
+            if (stopping) {
+                return;
+            }
+            stopping = true;
+        }
+        wakeup.notify_one();
+        flusher.join();
+    }
+
+    BatchingStats getStats() const {
+        lock_guard<mutex> lock(batchMutex);
+        return stats;
+    }
+
+    string getType() const override { return "Batched " + inner->getType(); }
+};
+
+struct NotificationChannel {
+    shared_ptr<NotificationService> service;
+    chrono::milliseconds timeout;
+};
+
+struct ChannelStats {
+    string channel;
+    uint64_t delivered = 0;
+    uint64_t failed = 0;
+    uint64_t timedOut = 0; // send() berhenti menunggu; pengiriman tetap jalan di background
+    uint64_t dropped = 0;  // Queue channel penuh (channel macet)
+};
+
+// Composite: satu pesan dikirim ke banyak channel sekaligus. Setiap channel punya
+// worker thread sendiri, jadi latency send() = channel paling lambat (dibatasi
+// timeout per channel), bukan jumlah semuanya. Channel yang gagal tidak mempengaruhi yang lain.
+class CompositeNotification : public NotificationService {
+private:
+    struct Delivery {
+        mutex doneMutex;
+        condition_variable doneChanged;
+        vector<bool> done;
+        shared_ptr<const string> message;
+    };
+
+    struct Child {
+        NotificationChannel channel;
+        deque<shared_ptr<Delivery>> queue;
+        mutex queueMutex;
+        condition_variable notEmpty;
+        bool stopping = false;
+        thread worker;
+        ChannelStats stats;
+    };
+
+    vector<unique_ptr<Child>> children;
+    size_t capacity;
+    once_flag shutdownOnce;
+    mutable mutex statsMutex; // Melindungi ChannelStats semua child
+
+    static vector<NotificationChannel> toChannels(const vector<shared_ptr<NotificationService>>& services,
+        chrono::milliseconds timeout) {
+        vector<NotificationChannel> channels;
+        for (const auto& service : services) {
+            channels.push_back(NotificationChannel{ service, timeout });
+        }
+        return channels;
+    }
+
+    void workerLoop(size_t childIndex) {
+        Child& child = *children[childIndex];
+        while (true) {
+            shared_ptr<Delivery> delivery;
+            {
+                unique_lock<mutex> lock(child.queueMutex);
+                child.notEmpty.wait(lock, [&] { return child.stopping || !child.queue.empty(); });
+                if (child.queue.empty()) {
+                    return; // Stopping dan queue sudah kosong (drained)
+                }
+                delivery = move(child.queue.front());
+                child.queue.pop_front();
+            }
+
+            bool delivered = true;
+            try {
+                child.channel.service->send(*delivery->message);
+            }
+            catch (const exception&) {
+                delivered = false;
+            }
+            {
+                lock_guard<mutex> lock(statsMutex);
+                if (delivered) {
+                    child.stats.delivered++;
+                }
+                else {
+                    child.stats.failed++;
+                }
+            }
+            {
+                lock_guard<mutex> lock(delivery->doneMutex);
+                delivery->done[childIndex] = true;
+            }
+            delivery->doneChanged.notify_all();
+        }
+    }
+
+public:
+    CompositeNotification(vector<NotificationChannel> channels, size_t queueCapacity = 256)
+        : capacity(queueCapacity) {
+        if (channels.empty() || queueCapacity == 0) {
+            throw invalid_argument("CompositeNotification needs at least one channel and queue slot");
+        }
+        for (auto& channel : channels) {
+            if (!channel.service) {
+                throw invalid_argument("CompositeNotification channel cannot be null");
+            }
+            auto child = make_unique<Child>();
+            child->stats.channel = channel.service->getType();
+            child->channel = move(channel);
+            children.push_back(move(child));
+        }
+        for (size_t i = 0; i < children.size(); ++i) {
+            children[i]->worker = thread(&CompositeNotification::workerLoop, this, i);
+        }
+    }
+
+    // Timeout yang sama untuk semua channel
+    CompositeNotification(const vector<shared_ptr<NotificationService>>& services,
+        chrono::milliseconds timeout = chrono::milliseconds(500), size_t queueCapacity = 256)
+        : CompositeNotification(toChannels(services, timeout), queueCapacity) {
+    }
+
+    ~CompositeNotification() override {
+        shutdown();
+    }
+
+    // Fan-out lalu tunggu setiap channel sampai selesai atau timeout-nya habis
+    void send(string_view message) override {
+        auto delivery = make_shared<Delivery>();
+        delivery->done.assign(children.size(), false);
+        delivery->message = make_shared<const string>(message);
+
+        auto started = chrono::steady_clock::now();
+        for (size_t i = 0; i < children.size(); ++i) {
+            Child& child = *children[i];
+            bool enqueued = false;
+            {
+                lock_guard<mutex> lock(child.queueMutex);
+                if (!child.stopping && child.queue.size() < capacity) {
+                    child.queue.push_back(delivery);
+                    enqueued = true;
+                }
+            }
+            if (enqueued) {
+                child.notEmpty.notify_one();
+            }
+            else {
+                lock_guard<mutex> doneLock(delivery->doneMutex);
+                delivery->done[i] = true; // Tidak ditunggu
+                lock_guard<mutex> lock(statsMutex);
+                child.stats.dropped++;
+            }
+        }
+
+        unique_lock<mutex> lock(delivery->doneMutex);
+        for (size_t i = 0; i < children.size(); ++i) {
+            auto deadline = started + children[i]->channel.timeout;
+            if (!delivery->doneChanged.wait_until(lock, deadline, [&] { return delivery->done[i]; })) {
+                lock_guard<mutex> statsLock(statsMutex);
+                children[i]->stats.timedOut++;
+            }
+        }
+    }
+
+    // Drain-on-shutdown: pesan yang sudah di-queue tetap dikirim
+    void shutdown() {
+        call_once(shutdownOnce, [this] {
+            for (auto& child : children) {
+                {
+                    lock_guard<mutex> lock(child->queueMutex);
+                    child->stopping = true;
+                }
+                child->notEmpty.notify_all();
+            }
+            for (auto& child : children) {
+                child->worker.join();
+            }
+        });
+    }
+
+    vector<ChannelStats> getStats() const {
+        lock_guard<mutex> lock(statsMutex);
+        vector<ChannelStats> snapshot;
+        for (const auto& child : children) {
+            snapshot.push_back(child->stats);
+        }
+        return snapshot;
+    }
+
+    string getType() const override {
+        string type = "Composite(";
+        for (size_t i = 0; i < children.size(); ++i) {
+            type += (i == 0 ? "" : ", ") + children[i]->stats.channel;
+        }
+        return type + ")";
+    }
+};
+
+enum class RateLimitPolicy {
+    Wait, // Tunggu sampai ada token (maksimal maxWait, lalu drop)
+    Drop  // Langsung buang pesan kalau tidak ada token
+};
+
+struct RateLimitStats {
+    uint64_t allowed = 0;
+    uint64_t throttled = 0; // Harus menunggu token
+    uint64_t dropped = 0;
+    chrono::microseconds totalWait{ 0 };
+};
+
+// Token bucket lock-free (GCRA): seluruh state adalah satu atomic "theoretical
+// arrival time". Di bawah kuota, send() hanya butuh satu load + satu CAS.
+class RateLimitedNotification : public NotificationService {
+private:
+    shared_ptr<NotificationService> inner;
+    RateLimitPolicy policy;
+    int64_t emissionInterval; // ns per token
+    int64_t burstTolerance;   // ns; burst token boleh dipakai sekaligus
+    chrono::nanoseconds maxWait;
+    const chrono::steady_clock::time_point epoch = chrono::steady_clock::now();
+
+    atomic<int64_t> theoreticalArrival{ 0 };
+    atomic<uint64_t> allowed{ 0 };
+    atomic<uint64_t> throttled{ 0 };
+    atomic<uint64_t> dropped{ 0 };
+    atomic<int64_t> waitedNanos{ 0 };
+
+    int64_t nowNanos() const {
+        return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - epoch).count();
+    }
+
+    // Ambil satu token; return 0 kalau berhasil, atau berapa ns harus menunggu
+    int64_t tryAcquire() {
+        int64_t now = nowNanos();
+        int64_t arrival = theoreticalArrival.load(memory_order_relaxed);
+        while (true) {
+            int64_t earliest = arrival - burstTolerance;
+            if (now < earliest) {
+                return earliest - now;
+            }
+            int64_t next = max(now, arrival) + emissionInterval;
+            if (theoreticalArrival.compare_exchange_weak(arrival, next, memory_order_relaxed)) {
+                return 0;
+            }
+        }
+    }
+
+public:
+    // ratePerSecond: refill rate; burst: token maksimum yang bisa dipakai sekaligus
+    RateLimitedNotification(shared_ptr<NotificationService> notif, double ratePerSecond, uint32_t burst = 1,
+        RateLimitPolicy limitPolicy = RateLimitPolicy::Wait,
+        chrono::milliseconds maxWaitTime = chrono::milliseconds(1000))
+        : inner(notif), policy(limitPolicy), maxWait(maxWaitTime) {
+        if (!(ratePerSecond > 0) || burst == 0) {
+            throw invalid_argument("RateLimitedNotification needs a positive rate and burst");
+        }
+        emissionInterval = max<int64_t>(1, static_cast<int64_t>(llround(1e9 / ratePerSecond)));
+        burstTolerance = emissionInterval * static_cast<int64_t>(burst - 1);
+    }
+
+    void send(string_view message) override {
+        int64_t wait = tryAcquire();
+        if (wait == 0) {
+            allowed.fetch_add(1, memory_order_relaxed);
+            inner->send(message);
+            return;
+        }
+
+        if (policy == RateLimitPolicy::Drop) {
+            dropped.fetch_add(1, memory_order_relaxed);
+            return;
+        }
+
+        throttled.fetch_add(1, memory_order_relaxed);
+        auto deadline = chrono::steady_clock::now() + maxWait;
+        auto waitStarted = chrono::steady_clock::now();
+        while (wait != 0) {
+            auto wakeAt = chrono::steady_clock::now() + chrono::nanoseconds(wait);
+            if (wakeAt > deadline) {
+                dropped.fetch_add(1, memory_order_relaxed);
+                return; // Menunggu lebih lama dari maxWait: buang
+            }
+            this_thread::sleep_until(wakeAt);
+            wait = tryAcquire(); // Thread lain bisa saja mengambil token lebih dulu
+        }
+        waitedNanos.fetch_add(chrono::duration_cast<chrono::nanoseconds>(
+            chrono::steady_clock::now() - waitStarted).count(), memory_order_relaxed);
+        allowed.fetch_add(1, memory_order_relaxed);
+        inner->send(message);
+    }
+
+    RateLimitStats getStats() const {
+        RateLimitStats stats;
+        stats.allowed = allowed.load(memory_order_relaxed);
+        stats.throttled = throttled.load(memory_order_relaxed);
+        stats.dropped = dropped.load(memory_order_relaxed);
+        stats.totalWait = chrono::duration_cast<chrono::microseconds>(
+            chrono::nanoseconds(waitedNanos.load(memory_order_relaxed)));
+        return stats;
+    }
+
+    string getType() const override { return "RateLimited " + inner->getType(); }
+};
+
+struct DeadLetter {
+    int64_t failedAtMillis; // system_clock, ms sejak epoch
+    uint32_t attempts;
+    string error;
+    string message;
+};
+
+struct ReplayResult {
+    size_t delivered = 0;
+    size_t failed = 0; // Tetap di dead-letter file
+};
+
+// Dead-letter file lokal: satu baris per pesan gagal
+// "<failedAtMillis>\t<attempts>\t<error>\t<message>\n", field di-escape (\\, \t, \n).
+class DeadLetterQueue {
+private:
+    string path;
+    mutable mutex fileMutex;
+    mutex replayMutex;
+    unique_ptr<FileHandle> file;
+    uint64_t writeOffset = 0;
+
+    static void escapeTo(string& out, string_view text) {
+        for (char c : text) {
+            switch (c) {
+            case '\\': out += "\\\\"; break;
+            case '\t': out += "\\t"; break;
+            case '\n': out += "\\n"; break;
+            default: out += c; break;
+            }
+        }
+    }
+
+    static string unescape(string_view text) {
+        string out;
+        out.reserve(text.size());
+        for (size_t i = 0; i < text.size(); ++i) {
+            if (text[i] == '\\' && i + 1 < text.size()) {
+                char next = text[++i];
+                out += next == 't' ? '\t' : (next == 'n' ? '\n' : next);
+            }
+            else {
+                out += text[i];
+            }
+        }
+        return out;
+    }
+
+    static string formatLine(const DeadLetter& letter) {
+        string line = to_string(letter.failedAtMillis) + '\t' + to_string(letter.attempts) + '\t';
+        escapeTo(line, letter.error);
+        line += '\t';
+        escapeTo(line, letter.message);
+        line += '\n';
+        return line;
+    }
+
+    static optional<DeadLetter> parseLine(string_view line) {
+        size_t first = line.find('\t');
+        size_t second = first == string_view::npos ? first : line.find('\t', first + 1);
+        size_t third = second == string_view::npos ? second : line.find('\t', second + 1);
+        if (third == string_view::npos) {
+            return nullopt;
+        }
+        DeadLetter letter{};
+        auto timeField = line.substr(0, first);
+        auto attemptsField = line.substr(first + 1, second - first - 1);
+        if (from_chars(timeField.data(), timeField.data() + timeField.size(), letter.failedAtMillis).ec != errc() ||
+            from_chars(attemptsField.data(), attemptsField.data() + attemptsField.size(), letter.attempts).ec != errc()) {
+            return nullopt;
+        }
+        letter.error = unescape(line.substr(second + 1, third - second - 1));
+        letter.message = unescape(line.substr(third + 1));
+        return letter;
+    }
+
+    // Dipanggil dengan fileMutex terkunci
+    vector<DeadLetter> readAllLocked() const {
+        string content(static_cast<size_t>(writeOffset), '\0');
+        content.resize(file->readAt(&content[0], content.size(), 0));
+
+        vector<DeadLetter> letters;
+        size_t start = 0;
+        while (start < content.size()) {
+            size_t end = content.find('\n', start);
+            if (end == string::npos) {
+                break;
+            }
+            if (auto letter = parseLine(string_view(content).substr(start, end - start))) {
+                letters.push_back(move(*letter));
+            }
+            start = end + 1;
+        }
+        return letters;
+    }
+
+public:
+    explicit DeadLetterQueue(const string& filePath)
+        : path(filePath), file(make_unique<FileHandle>(filePath, O_RDWR | O_CREAT)) {
+        // Buang baris terakhir yang terpotong (crash saat append)
+        string content(static_cast<size_t>(file->size()), '\0');
+        content.resize(file->readAt(&content[0], content.size(), 0));
+        size_t lastNewline = content.find_last_of('\n');
+        writeOffset = lastNewline == string::npos ? 0 : lastNewline + 1;
+        if (writeOffset != content.size()) {
+            file->truncate(writeOffset);
+        }
+    }
+
+    // Append + fdatasync; dead letter jarang, jadi durability lebih penting dari throughput
+    void append(string_view message, uint32_t attempts, string_view error) {
+        DeadLetter letter{ chrono::duration_cast<chrono::milliseconds>(
+            chrono::system_clock::now().time_since_epoch()).count(), attempts, string(error), string(message) };
+        string line = formatLine(letter);
+        lock_guard<mutex> lock(fileMutex);
+        file->writeAt(line.data(), line.size(), writeOffset);
+        writeOffset += line.size();
+        file->sync();
+    }
+
+    vector<DeadLetter> readAll() const {
+        lock_guard<mutex> lock(fileMutex);
+        return readAllLocked();
+    }
+
+    // Kirim ulang semua dead letter ke target; yang masih gagal ditulis kembali
+    // (file sementara + fsync + rename, file lama utuh kalau crash di tengah).
+    // Pengiriman berjalan tanpa fileMutex, jadi append() tidak tertahan provider
+    // yang lambat; baris yang di-append selama replay ikut disalin ke file baru.
+    ReplayResult replay(NotificationService& target) {
+        lock_guard<mutex> replayLock(replayMutex); // Satu replay pada satu waktu
+        vector<DeadLetter> letters;
+        uint64_t replayedUntil;
+        {
+            lock_guard<mutex> lock(fileMutex);
+            letters = readAllLocked();
+            replayedUntil = writeOffset;
+        }
+
+        ReplayResult result;
+        string remaining;
+        for (auto& letter : letters) {
+            SendResult sent = target.trySend(letter.message);
+            if (sent.delivered) {
+                result.delivered++;
+                continue;
+            }
+            result.failed++;
+            letter.attempts++;
+            letter.error = sent.error;
+            remaining += formatLine(letter);
+        }
+
+        lock_guard<mutex> lock(fileMutex);
+        if (writeOffset > replayedUntil) {
+            size_t appendedSize = static_cast<size_t>(writeOffset - replayedUntil);
+            size_t keptSize = remaining.size();
+            remaining.resize(keptSize + appendedSize);
+            if (file->readAt(&remaining[keptSize], appendedSize, replayedUntil) != appendedSize) {
+                throw runtime_error("Short read in dead-letter file: " + path);
+            }
+        }
+
+        string temporaryPath = path + ".tmp";
+        auto replacement = make_unique<FileHandle>(temporaryPath, O_RDWR | O_CREAT | O_TRUNC);
+        replacement->writeAt(remaining.data(), remaining.size(), 0);
+        replacement->sync();
+        if (::rename(temporaryPath.c_str(), path.c_str()) != 0) {
+            throw runtime_error("rename failed for " + temporaryPath + ": " + strerror(errno));
+        }
+        syncDirectoryOf(path);
+        file = move(replacement);
+        writeOffset = remaining.size();
+        return result;
+    }
+
+    size_t size() const {
+        lock_guard<mutex> lock(fileMutex);
+        return readAllLocked().size();
+    }
+};
+
+struct RetryPolicy {
+    uint32_t maxAttempts = 5;
+    chrono::milliseconds baseDelay{ 100 };
+    chrono::milliseconds maxDelay{ 10000 };
+};
+
+struct RetryStats {
+    uint64_t enqueued = 0;
+    uint64_t attempts = 0;
+    uint64_t delivered = 0;
+    uint64_t retried = 0;
+    uint64_t deadLettered = 0;
+    uint64_t overflowed = 0; // Queue penuh atau shutdown: diteruskan worker ke dead-letter file tanpa retry
+    uint64_t lost = 0;       // Dead-letter file gagal ditulis, spill juga penuh, atau send setelah worker selesai
+    size_t pending = 0;
+};
+
+// Retry decorator: send() hanya enqueue (tidak pernah menunggu provider atau disk),
+// worker thread mencoba inner->trySend() dengan exponential backoff + jitter. Setelah
+// maxAttempts, pesan masuk dead-letter file untuk di-replay nanti. Kalau queue
+// penuh, pesan ditaruh di spill in-memory dan worker yang menulisnya ke file.
+class RetryingNotification : public NotificationService {
+private:
+    struct Attempt {
+        string message;
+        uint32_t attempt;
+        chrono::steady_clock::time_point dueAt;
+    };
+
+    struct LaterDue {
+        bool operator()(const Attempt& a, const Attempt& b) const { return a.dueAt > b.dueAt; }
+    };
+
+    struct Spilled {
+        string message;
+        const char* reason;
+    };
+
+    shared_ptr<NotificationService> inner;
+    shared_ptr<DeadLetterQueue> deadLetters;
+    RetryPolicy policy;
+    size_t capacity;
+
+    mutable mutex retryMutex;
+    condition_variable wakeup;
+    priority_queue<Attempt, vector<Attempt>, LaterDue> pending; // Paling cepat due di atas
+    vector<Spilled> overflow; // Spill saat pending penuh atau setelah shutdown; dibatasi capacity juga
+    bool stopping = false;
+    bool drained = false; // Worker sudah selesai: tidak ada lagi yang mengosongkan overflow
+    RetryStats stats;
+    mt19937_64 random{ random_device{}() }; // Hanya dipakai worker thread
+    thread worker;
+
+    // Equal jitter: delay acak di [cap/2, cap], cap = min(maxDelay, base * 2^(attempt-1))
+    chrono::milliseconds backoff(uint32_t attempt) {
+        int64_t cap = policy.baseDelay.count() << min<uint32_t>(attempt - 1, 30);
+        cap = min<int64_t>(cap, policy.maxDelay.count());
+        uniform_int_distribution<int64_t> jitter(cap / 2, cap);
+        return chrono::milliseconds(jitter(random));
+    }
+
+    void deadLetter(const string& message, uint32_t attempts, const string& error) {
+        bool written = true;
+        try {
+            deadLetters->append(message, attempts, error);
+        }
+        catch (const exception&) {
+            written = false;
+        }
+        lock_guard<mutex> lock(retryMutex);
+        if (written) {
+            stats.deadLettered++;
+        }
+        else {
+            stats.lost++;
+        }
+    }
+
+    void workerLoop() {
+        unique_lock<mutex> lock(retryMutex);
+        while (true) {
+            if (!overflow.empty()) {
+                vector<Spilled> spilled;
+                spilled.swap(overflow);
+                lock.unlock();
+                for (const auto& entry : spilled) {
+                    deadLetter(entry.message, 0, entry.reason);
+                }
+                lock.lock();
+                continue;
+            }
+            if (pending.empty()) {
+                if (stopping) {
+                    drained = true; // Dicek send() di bawah lock yang sama
+                    return;
+                }
+                wakeup.wait(lock, [this] { return stopping || !pending.empty() || !overflow.empty(); });
+                continue;
+            }
+            // Saat shutdown backoff dilewati: setiap pesan dapat satu percobaan terakhir
+            if (!stopping && pending.top().dueAt > chrono::steady_clock::now()) {
+                wakeup.wait_until(lock, pending.top().dueAt);
+                continue;
+            }
+
+            Attempt attempt = pending.top();
+            pending.pop();
+            bool finalAttempt = stopping;
+            stats.attempts++;
+            lock.unlock();
+
+            SendResult result = inner->trySend(attempt.message);
+            attempt.attempt++;
+            if (!result.delivered && (finalAttempt || attempt.attempt >= policy.maxAttempts)) {
+                deadLetter(attempt.message, attempt.attempt, result.error);
+                lock.lock();
+                continue;
+            }
+            if (!result.delivered) {
+                attempt.dueAt = chrono::steady_clock::now() + backoff(attempt.attempt);
+            }
+
+            lock.lock();
+            if (result.delivered) {
+                stats.delivered++;
+            }
+            else {
+                stats.retried++;
+                pending.push(move(attempt));
+            }
+        }
+    }
+
+public:
+    RetryingNotification(shared_ptr<NotificationService> notif, shared_ptr<DeadLetterQueue> deadLetterQueue,
+        RetryPolicy retryPolicy = RetryPolicy{}, size_t queueCapacity = 4096)
+        : inner(notif), deadLetters(deadLetterQueue), policy(retryPolicy), capacity(queueCapacity) {
+        if (!deadLetters || policy.maxAttempts == 0 || queueCapacity == 0) {
+            throw invalid_argument("RetryingNotification needs a dead-letter queue, attempts and queue slots");
+        }
+        worker = thread(&RetryingNotification::workerLoop, this);
+    }
+
+    ~RetryingNotification() override {
+        shutdown();
+    }
+
+    // Tidak pernah memblok pada provider atau disk: queue penuh -> spill in-memory.
+    // Setelah shutdown() dimulai pesan juga masuk spill dan worker menulisnya ke
+    // dead-letter file sebelum berhenti; setelah worker selesai pesan dihitung lost.
+    void send(string_view message) override {
+        unique_lock<mutex> lock(retryMutex);
+        if (stopping || pending.size() >= capacity) {
+            if (drained || overflow.size() >= capacity) {
+                stats.lost++;
+                return;
+            }
+            overflow.push_back(Spilled{ string(message), stopping ? "retry queue stopped" : "retry queue full" });
+            stats.overflowed++;
+        }
+        else {
+            pending.push(Attempt{ string(message), 0, chrono::steady_clock::now() });
+            stats.enqueued++;
+        }
+        lock.unlock();
+        wakeup.notify_one();
+    }
+
+    // Pesan yang belum terkirim mendapat satu percobaan terakhir, sisanya (termasuk
+    // spill) ditulis worker ke dead-letter file sebelum join
+    void shutdown() {
+        {
+            lock_guard<mutex> lock(retryMutex);
+            if (stopping) {
+                return;
+            }
+            stopping = true;
+        }
+        wakeup.notify_one();
+        worker.join();
+    }
+
+    RetryStats getStats() const {
+        lock_guard<mutex> lock(retryMutex);
+        RetryStats snapshot = stats;
+        snapshot.pending = pending.size();
+        return snapshot;
+    }
+
+    string getType() const override { return "Retrying " + inner->getType(); }
+};
+
+struct CacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    uint64_t invalidations = 0;
+    size_t entries = 0;
+    size_t bytes = 0;
+};
+
+// Read-through LRU cache untuk findById, di-shard supaya lock tidak jadi bottleneck
+class CachingDatabase : public DatabaseService {
+private:
+    using LruList = list<pair<int, Order>>; // front = most recently used
+
+    struct Shard {
+        mutex shardMutex;
+        LruList lru;
+        unordered_map<int, LruList::iterator> index;
+        size_t bytes = 0;
+        // Naik di setiap invalidate. Miss mencatat epoch sebelum membaca backend;
+        // kalau berubah, hasil bacaan mungkin sudah basi dan tidak di-cache.
+        uint64_t epoch = 0;
+    };
+
+    shared_ptr<DatabaseService> inner;
+    vector<unique_ptr<Shard>> shards;
+    size_t shardByteBudget;
+
+    atomic<uint64_t> hits{ 0 };
+    atomic<uint64_t> misses{ 0 };
+    atomic<uint64_t> evictions{ 0 };
+    atomic<uint64_t> invalidations{ 0 };
+
+    // Perkiraan memory satu entry: object + string payload + node list/map
+    static size_t entryBytes(const Order& order) {
+        return sizeof(Order) + order.getDescription().size() +
+            order.getPaymentType().size() + order.getPaymentInfo().size() +
+            2 * sizeof(void*) + sizeof(pair<const int, LruList::iterator>) + 2 * sizeof(void*);
+    }
+
+    size_t shardIndexFor(int id) const {
+        return static_cast<unsigned int>(id) % shards.size();
+    }
+
+    Shard& shardFor(int id) {
+        return *shards[shardIndexFor(id)];
+    }
+
+    void eraseLocked(Shard& shard, unordered_map<int, LruList::iterator>::iterator entry) {
+        shard.bytes -= entryBytes(entry->second->second);
+        shard.lru.erase(entry->second);
+        shard.index.erase(entry);
+    }
+
+    // seenEpoch: epoch shard sebelum order dibaca dari backend
+    void insert(const Order& order, uint64_t seenEpoch) {
+        size_t bytes = entryBytes(order);
+        if (bytes > shardByteBudget) {
+            return; // Terlalu besar untuk di-cache
+        }
+
+        Shard& shard = shardFor(order.getId());
+        lock_guard<mutex> lock(shard.shardMutex);
+        if (shard.epoch != seenEpoch) {
+            return; // Ada save() selama miss: bisa jadi versi lama
+        }
+        if (shard.index.count(order.getId()) == 0) {
+            shard.lru.emplace_front(order.getId(), order);
+            shard.index[order.getId()] = shard.lru.begin();
+            shard.bytes += bytes;
+
+            while (shard.bytes > shardByteBudget) {
+                eraseLocked(shard, shard.index.find(shard.lru.back().first));
+                evictions++;
+            }
+        }
+    }
+
+    void invalidate(int id) {
+        Shard& shard = shardFor(id);
+        lock_guard<mutex> lock(shard.shardMutex);
+        shard.epoch++; // Juga saat id belum di-cache: miss yang sedang jalan harus tahu
+        auto entry = shard.index.find(id);
+        if (entry != shard.index.end()) {
+            eraseLocked(shard, entry);
+            invalidations++;
+        }
+    }
+
+public:
+    CachingDatabase(shared_ptr<DatabaseService> db,
+        size_t byteBudget = 8 * 1024 * 1024, size_t shardCount = 16)
+        : inner(db) {
+        if (shardCount == 0) {
+            throw invalid_argument("CachingDatabase needs at least one shard");
+        }
+        shardByteBudget = byteBudget / shardCount;
+        for (size_t i = 0; i < shardCount; ++i) {
+            shards.push_back(make_unique<Shard>());
+        }
+    }
+
+    // Write-through ke backend, lalu invalidate entry cache
+    void save(const Order& order) override {
+        inner->save(order);
+        invalidate(order.getId());
+    }
+
+    void saveBatch(OrderSpan orders) override {
+        inner->saveBatch(orders);
+        for (const auto& order : orders) {
+            invalidate(order.getId());
+        }
+    }
+
+    Order findById(int id) override {
+        Shard& shard = shardFor(id);
+        uint64_t seenEpoch;
+        {
+            lock_guard<mutex> lock(shard.shardMutex);
+            auto entry = shard.index.find(id);
+            if (entry != shard.index.end()) {
+                shard.lru.splice(shard.lru.begin(), shard.lru, entry->second);
+                hits++;
+                return entry->second->second;
+            }
+            seenEpoch = shard.epoch;
+        }
+
+        // Miss: baca dari backend tanpa memegang lock shard
+        misses++;
+        Order order = inner->findById(id);
+        insert(order, seenEpoch);
+        return order;
+    }
+
+    // Hit dilayani dari cache; semua miss dikirim ke backend dalam satu batch
+    void findByIds(IdSpan ids, vector<Order>& found, vector<int>& missing) override {
+        vector<int> uncached;
+        vector<optional<uint64_t>> seenEpochs(shards.size()); // Epoch pertama yang terlihat per shard
+        for (int id : ids) {
+            size_t shardIndex = shardIndexFor(id);
+            Shard& shard = *shards[shardIndex];
+            lock_guard<mutex> lock(shard.shardMutex);
+            auto entry = shard.index.find(id);
+            if (entry != shard.index.end()) {
+                shard.lru.splice(shard.lru.begin(), shard.lru, entry->second);
+                hits++;
+                found.push_back(entry->second->second);
+            }
+            else {
+                uncached.push_back(id);
+                if (!seenEpochs[shardIndex]) {
+                    seenEpochs[shardIndex] = shard.epoch;
+                }
+            }
+        }
+        if (uncached.empty()) {
+            return;
+        }
+
+        misses += uncached.size();
+        size_t firstLoaded = found.size();
+        inner->findByIds(uncached, found, missing);
+        for (size_t i = firstLoaded; i < found.size(); ++i) {
+            optional<uint64_t> seenEpoch = seenEpochs[shardIndexFor(found[i].getId())];
+            if (seenEpoch) {
+                insert(found[i], *seenEpoch);
+            }
+        }
+    }
+
+    CacheStats getStats() const {
+        CacheStats stats;
+        stats.hits = hits;
+        stats.misses = misses;
+        stats.evictions = evictions;
+        stats.invalidations = invalidations;
+        for (const auto& shard : shards) {
+            lock_guard<mutex> lock(shard->shardMutex);
+            stats.entries += shard->index.size();
+            stats.bytes += shard->bytes;
+        }
+        return stats;
+    }
+
+    string getType() const override { return "Cached " + inner->getType(); }
+};
+
+// Durability untuk backend apa pun: record masuk WAL dulu, baru diteruskan ke inner.
+// Saat konstruksi, isi WAL di-replay ke inner (save bersifat upsert, jadi replay
+// record yang sudah ada di inner aman). checkpoint() mengosongkan WAL setelah
+// inner dibuat durable lewat syncInner; tanpa syncInner (inner volatile) WAL
+// tidak boleh dipotong dan checkpoint() melempar logic_error.
+class DurableDatabase : public DatabaseService {
+private:
+    shared_ptr<DatabaseService> inner;
+    shared_ptr<WriteAheadLog> wal;
+    function<void()> syncInner;
+    shared_mutex checkpointMutex; // Shared: save/saveBatch, exclusive: checkpoint
+
+public:
+    DurableDatabase(shared_ptr<DatabaseService> db, shared_ptr<WriteAheadLog> log,
+        function<void()> innerSync = nullptr)
+        : inner(db), wal(log), syncInner(move(innerSync)) {
+        recover();
+    }
+
+    // Replay semua record WAL ke inner; return jumlah record yang di-replay
+    size_t recover() {
+        unique_lock<shared_mutex> lock(checkpointMutex);
+        vector<Order> orders;
+        wal->replay([&](const Order& order) { orders.push_back(order); });
+        if (!orders.empty()) {
+            inner->saveBatch(orders);
+        }
+        return orders.size();
+    }
+
+    // Buat inner durable lalu kosongkan WAL. Write baru menunggu selama checkpoint
+    // supaya tidak ada record yang masuk WAL di antara sync inner dan reset.
+    void checkpoint() {
+        if (!syncInner) {
+            throw logic_error("Cannot checkpoint " + inner->getType() + ": inner store has no sync hook");
+        }
+        unique_lock<shared_mutex> lock(checkpointMutex);
+        syncInner();
+        wal->reset();
+    }
+
+    void save(const Order& order) override {
+        string record;
+        OrderCodec::encode(order, record);
+        shared_lock<shared_mutex> lock(checkpointMutex);
+        wal->append(record);
+        inner->save(order);
+    }
+
+    // Satu WAL append (dan paling banyak satu fsync) untuk seluruh batch
+    void saveBatch(OrderSpan orders) override {
+        string records;
+        for (const auto& order : orders) {
+            OrderCodec::encode(order, records);
+        }
+        shared_lock<shared_mutex> lock(checkpointMutex);
+        wal->append(records);
+        inner->saveBatch(orders);
+    }
+
+    Order findById(int id) override {
+        return inner->findById(id);
+    }
+
+    void findByIds(IdSpan ids, vector<Order>& found, vector<int>& missing) override {
+        inner->findByIds(ids, found, missing);
+    }
+
+    string getType() const override { return "Durable " + inner->getType(); }
+};
+
+// Partisi order berdasarkan id ke beberapa backend memakai consistent hashing.
+// Posisi shard di ring ditentukan oleh namanya, jadi routing sama setelah restart
+// selama nama shard sama. Tambah/hapus shard hanya memindahkan ~1/N id; migrasi
+// data lama dilakukan caller (pakai shardFor() untuk tahu tujuan baru).
+class ShardedDatabase : public DatabaseService {
+private:
+    static constexpr int VIRTUAL_NODES = 64; // Titik per shard di ring
+
+    struct Shard {
+        string name; // Key stabil untuk posisi ring, dipilih caller
+        shared_ptr<DatabaseService> database;
+    };
+
+    struct RingPoint {
+        uint64_t hash;
+        shared_ptr<DatabaseService> shard;
+    };
+
+    mutable shared_mutex ringMutex;
+    vector<Shard> shards;
+    vector<RingPoint> ring; // Sorted by hash
+
+    // FNV-1a: tidak bergantung pada std::hash, jadi sama antar build/platform
+    static uint64_t nameHash(const string& name) {
+        uint64_t hash = 0xCBF29CE484222325ULL;
+        for (unsigned char c : name) {
+            hash = (hash ^ c) * 0x100000001B3ULL;
+        }
+        return mixHash(hash);
+    }
+
+    void rebuildRing() {
+        ring.clear();
+        for (const auto& shard : shards) {
+            uint64_t base = nameHash(shard.name);
+            for (uint64_t v = 0; v < VIRTUAL_NODES; ++v) {
+                ring.push_back(RingPoint{ mixHash(base + v), shard.database });
+            }
+        }
+        sort(ring.begin(), ring.end(),
+            [](const RingPoint& a, const RingPoint& b) { return a.hash < b.hash; });
+    }
+
+    void addShardLocked(const string& name, shared_ptr<DatabaseService> shard) {
+        for (const auto& existing : shards) {
+            if (existing.name == name) {
+                throw invalid_argument("Duplicate shard name: " + name);
+            }
+        }
+        shards.push_back(Shard{ name, shard });
+    }
+
+    const shared_ptr<DatabaseService>& routeLocked(int id) const {
+        if (ring.empty()) {
+            throw logic_error("ShardedDatabase has no shards");
+        }
+        uint64_t hash = mixHash(static_cast<uint32_t>(id));
+        auto point = lower_bound(ring.begin(), ring.end(), hash,
+            [](const RingPoint& p, uint64_t value) { return p.hash < value; });
+        return point == ring.end() ? ring.front().shard : point->shard;
+    }
+
+public:
+    // Nama shard eksplisit: routing hanya bergantung pada nama, bukan urutan
+    explicit ShardedDatabase(const vector<pair<string, shared_ptr<DatabaseService>>>& namedChildren) {
+        for (const auto& child : namedChildren) {
+            addShardLocked(child.first, child.second);
+        }
+        rebuildRing();
+    }
+
+    // Nama otomatis "shard-0", "shard-1", ... menurut posisi di vector. Routing
+    // hanya stabil kalau caller membuat ulang daftar yang sama setelah restart.
+    explicit ShardedDatabase(const vector<shared_ptr<DatabaseService>>& children) {
+        for (size_t i = 0; i < children.size(); ++i) {
+            addShardLocked("shard-" + to_string(i), children[i]);
+        }
+        rebuildRing();
+    }
+
+    shared_ptr<DatabaseService> shardFor(int id) const {
+        shared_lock<shared_mutex> lock(ringMutex);
+        return routeLocked(id);
+    }
+
+    void addShard(const string& name, shared_ptr<DatabaseService> shard) {
+        unique_lock<shared_mutex> lock(ringMutex);
+        addShardLocked(name, shard);
+        rebuildRing();
+    }
+
+    void removeShard(const string& name) {
+        unique_lock<shared_mutex> lock(ringMutex);
+        auto entry = find_if(shards.begin(), shards.end(), [&name](const Shard& s) { return s.name == name; });
+        if (entry == shards.end()) {
+            throw out_of_range("Shard not found: " + name);
+        }
+        shards.erase(entry);
+        rebuildRing();
+    }
+
+    vector<string> getShardNames() const {
+        shared_lock<shared_mutex> lock(ringMutex);
+        vector<string> names;
+        for (const auto& shard : shards) {
+            names.push_back(shard.name);
+        }
+        return names;
+    }
+
+    void save(const Order& order) override {
+        shardFor(order.getId())->save(order);
+    }
+
+    // Kelompokkan per shard, lalu kirim semua kelompok secara paralel
+    void saveBatch(OrderSpan orders) override {
+        map<DatabaseService*, pair<shared_ptr<DatabaseService>, vector<Order>>> groups;
+        {
+            shared_lock<shared_mutex> lock(ringMutex);
+            for (const auto& order : orders) {
+                const auto& shard = routeLocked(order.getId());
+                auto& group = groups[shard.get()];
+                group.first = shard;
+                group.second.push_back(order);
+            }
+        }
+
+        if (groups.size() == 1) {
+            auto& group = groups.begin()->second;
+            group.first->saveBatch(group.second);
+            return;
+        }
+
+        vector<future<void>> pending;
+        for (auto& entry : groups) {
+            auto& group = entry.second;
+            pending.push_back(async(launch::async, [&group] {
+                group.first->saveBatch(group.second);
+            }));
+        }
+        for (auto& result : pending) {
+            result.wait(); // Tunggu semua dulu sebelum ada exception yang dilempar
+        }
+        for (auto& result : pending) {
+            result.get();
+        }
+    }
+
+    Order findById(int id) override {
+        return shardFor(id)->findById(id);
+    }
+
+    // Satu findByIds per shard, semua shard secara paralel seperti saveBatch.
+    // Setiap kelompok mengisi vector-nya sendiri; digabung setelah semua selesai.
+    void findByIds(IdSpan ids, vector<Order>& found, vector<int>& missing) override {
+        struct LookupGroup {
+            shared_ptr<DatabaseService> shard;
+            vector<int> ids;
+            vector<Order> found;
+            vector<int> missing;
+        };
+        map<DatabaseService*, LookupGroup> groups;
+        {
+            shared_lock<shared_mutex> lock(ringMutex);
+            for (int id : ids) {
+                const auto& shard = routeLocked(id);
+                auto& group = groups[shard.get()];
+                group.shard = shard;
+                group.ids.push_back(id);
+            }
+        }
+
+        if (groups.size() == 1) {
+            auto& group = groups.begin()->second;
+            group.shard->findByIds(group.ids, found, missing);
+            return;
+        }
+
+        vector<future<void>> pending;
+        for (auto& entry : groups) {
+            auto& group = entry.second;
+            pending.push_back(async(launch::async, [&group] {
+                group.shard->findByIds(group.ids, group.found, group.missing);
+            }));
+        }
+        for (auto& result : pending) {
+            result.wait(); // Tunggu semua dulu sebelum ada exception yang dilempar
+        }
+        for (auto& result : pending) {
+            result.get();
+        }
+        for (auto& entry : groups) {
+            auto& group = entry.second;
+            move(group.found.begin(), group.found.end(), back_inserter(found));
+            missing.insert(missing.end(), group.missing.begin(), group.missing.end());
+        }
+    }
+
+    size_t getShardCount() const {
+        shared_lock<shared_mutex> lock(ringMutex);
+        return shards.size();
+    }
+
+    string getType() const override {
+        return "Sharded (" + to_string(getShardCount()) + " shards)";
+    }
+};
+
+enum class WriteQuorum {
+    One,      // Ack setelah replica pertama berhasil
+    Majority, // Ack setelah lebih dari setengah replica berhasil
+    All       // Ack setelah semua replica berhasil
+};
+
+struct ReplicaStats {
+    string type;
+    bool healthy = true;
+    uint64_t appliedWrites = 0;
+    uint64_t failedWrites = 0;
+    uint64_t lag = 0;              // Write yang sudah di-enqueue tapi belum diterapkan
+    uint64_t missedWrites = 0;     // Write gagal yang menunggu di-replay (replica belum sehat)
+    uint64_t appliedSequence = 0;  // Semua write dengan sequence <= ini sudah diterapkan
+    bool diverged = false;         // Terlalu banyak write terlewat; butuh resync manual
+    int64_t latencyMicros = 0;     // Rata-rata bergerak (EWMA) latency operasi
+};
+
+// Dual-write / fan-out replication: setiap replica punya worker thread sendiri,
+// jadi latency save = replica ke-quorum tercepat, bukan jumlah semua replica.
+// Setiap write punya sequence number; replica menerapkan write berurutan dan write
+// yang gagal di-replay (urut) sebelum write berikutnya, jadi replica hanya sehat
+// kalau tidak ada write yang terlewat. Read hanya ke replica yang sudah menerapkan
+// write terakhir yang di-ack (read-your-writes).
+class ReplicatedDatabase : public DatabaseService {
+private:
+    static constexpr size_t MAX_MISSED_WRITES = 10000; // Di atas ini replica dianggap diverged
+
+    struct WriteAck {
+        mutex ackMutex;
+        condition_variable done;
+        size_t succeeded = 0;
+        size_t failed = 0;
+        string lastError;
+
+        void report(const string& error) {
+            lock_guard<mutex> lock(ackMutex);
+            if (error.empty()) {
+                succeeded++;
+            }
+            else {
+                failed++;
+                lastError = error;
+            }
+            done.notify_all();
+        }
+    };
+
+    struct PendingWrite {
+        uint64_t sequence;
+        shared_ptr<const function<void(DatabaseService&)>> operation;
+        shared_ptr<WriteAck> ack;
+        bool reported = false; // Ack sudah menerima hasil (gagal) untuk write ini
+    };
+
+    struct Replica {
+        shared_ptr<DatabaseService> database;
+        thread worker;
+        mutex queueMutex;
+        condition_variable hasWork;
+        deque<PendingWrite> writes;
+        bool stopping = false;
+        deque<PendingWrite> missed; // Hanya disentuh worker thread
+
+        atomic<bool> healthy{ true };
+        atomic<bool> diverged{ false };
+        atomic<uint64_t> appliedSequence{ 0 };
+        atomic<uint64_t> missedCount{ 0 };
+        atomic<uint64_t> enqueued{ 0 };
+        atomic<uint64_t> applied{ 0 };
+        atomic<uint64_t> failed{ 0 };
+        atomic<int64_t> latencyNanos{ 0 };
+
+        void recordLatency(chrono::steady_clock::duration elapsed) {
+            int64_t sample = chrono::duration_cast<chrono::nanoseconds>(elapsed).count();
+            int64_t previous = latencyNanos.load(memory_order_relaxed);
+            latencyNanos.store(previous == 0 ? sample : previous - previous / 8 + sample / 8,
+                memory_order_relaxed);
+        }
+
+        uint64_t lag() const {
+            uint64_t done = applied.load() + failed.load(); // Baca sebelum enqueued supaya tidak underflow
+            return enqueued.load() - done;
+        }
+
+        // Write baru masuk di belakang write yang terlewat; terapkan urut sampai ada
+        // yang gagal. Replica baru sehat lagi setelah semua write terlewat berhasil.
+        void apply(PendingWrite write) {
+            if (diverged) {
+                failed++;
+                write.ack->report("replica diverged, needs resync");
+                return;
+            }
+            missed.push_back(move(write));
+            while (!missed.empty()) {
+                PendingWrite& next = missed.front();
+                auto start = chrono::steady_clock::now();
+                string error;
+                try {
+                    (*next.operation)(*database);
+                }
+                catch (const exception& writeError) {
+                    error = writeError.what();
+                }
+                recordLatency(chrono::steady_clock::now() - start);
+
+                if (!error.empty()) {
+                    healthy = false;
+                    if (!missed.back().reported) {
+                        failed++;
+                        missed.back().reported = true;
+                        missed.back().ack->report(error);
+                    }
+                    if (missed.size() > MAX_MISSED_WRITES) {
+                        diverged = true;
+                        missed.clear();
+                    }
+                    break;
+                }
+
+                appliedSequence = next.sequence;
+                if (!next.reported) {
+                    applied++;
+                    next.ack->report("");
+                }
+                else {
+                    failed--; // Berhasil di-replay: tidak lagi dihitung gagal
+                    applied++;
+                }
+                missed.pop_front();
+            }
+            missedCount = missed.size();
+            if (missed.empty() && !diverged) {
+                healthy = true;
+            }
+        }
+
+        void run() {
+            while (true) {
+                PendingWrite write;
+                {
+                    unique_lock<mutex> lock(queueMutex);
+                    hasWork.wait(lock, [this] { return stopping || !writes.empty(); });
+                    if (writes.empty()) {
+                        return; // Stopping dan semua write sudah diterapkan
+                    }
+                    write = move(writes.front());
+                    writes.pop_front();
+                }
+                apply(move(write));
+            }
+        }
+    };
+
+    vector<unique_ptr<Replica>> replicas;
+    size_t requiredAcks;
+    mutex sequenceMutex; // Sequence dan urutan enqueue sama di semua replica
+    uint64_t nextSequence = 1;
+    atomic<uint64_t> acknowledgedSequence{ 0 }; // Sequence tertinggi yang sudah di-ack ke caller
+
+    // Jalankan operasi write di semua replica, tunggu sampai quorum tercapai
+    void replicate(function<void(DatabaseService&)> write) {
+        auto ack = make_shared<WriteAck>();
+        auto operation = make_shared<const function<void(DatabaseService&)>>(move(write));
+
+        uint64_t sequence;
+        {
+            lock_guard<mutex> sequenceLock(sequenceMutex);
+            sequence = nextSequence++;
+            for (auto& replica : replicas) {
+                replica->enqueued++;
+                {
+                    lock_guard<mutex> lock(replica->queueMutex);
+                    replica->writes.push_back(PendingWrite{ sequence, operation, ack });
+                }
+                replica->hasWork.notify_one();
+            }
+        }
+
+        size_t total = replicas.size();
+        unique_lock<mutex> lock(ack->ackMutex);
+        ack->done.wait(lock, [&] {
+            return ack->succeeded >= requiredAcks || total - ack->failed < requiredAcks;
+        });
+        if (ack->succeeded < requiredAcks) {
+            throw runtime_error("Write quorum not reached (" + to_string(ack->succeeded) + "/" +
+                to_string(requiredAcks) + "): " + ack->lastError);
+        }
+
+        uint64_t acknowledged = acknowledgedSequence.load();
+        while (acknowledged < sequence && !acknowledgedSequence.compare_exchange_weak(acknowledged, sequence)) {
+        }
+    }
+
+public:
+    ReplicatedDatabase(const vector<shared_ptr<DatabaseService>>& databases,
+        WriteQuorum quorum = WriteQuorum::Majority) {
+        if (databases.empty()) {
+            throw invalid_argument("ReplicatedDatabase needs at least one replica");
+        }
+        for (const auto& database : databases) {
+            auto replica = make_unique<Replica>();
+            replica->database = database;
+            replicas.push_back(move(replica));
+        }
+        for (auto& replica : replicas) {
+            replica->worker = thread(&Replica::run, replica.get());
+        }
+
+        switch (quorum) {
+        case WriteQuorum::One: requiredAcks = 1; break;
+        case WriteQuorum::Majority: requiredAcks = replicas.size() / 2 + 1; break;
+        default: requiredAcks = replicas.size(); break;
+        }
+    }
+
+    // Replica yang lambat tetap menyelesaikan write yang tertunda sebelum berhenti
+    ~ReplicatedDatabase() override {
+        for (auto& replica : replicas) {
+            {
+                lock_guard<mutex> lock(replica->queueMutex);
+                replica->stopping = true;
+            }
+            replica->hasWork.notify_all();
+        }
+        for (auto& replica : replicas) {
+            replica->worker.join();
+        }
+    }
+
+    void save(const Order& order) override {
+        replicate([order](DatabaseService& database) { database.save(order); });
+    }
+
+    void saveBatch(OrderSpan orders) override {
+        auto batch = make_shared<const vector<Order>>(orders.begin(), orders.end());
+        replicate([batch](DatabaseService& database) { database.saveBatch(*batch); });
+    }
+
+    // Hanya replica yang sudah menerapkan semua write yang di-ack; yang sehat dan
+    // tercepat didahulukan. out_of_range dari satu replica -> coba replica berikutnya.
+    Order findById(int id) override {
+        uint64_t required = acknowledgedSequence.load();
+        vector<Replica*> candidates;
+        for (auto& replica : replicas) {
+            if (replica->appliedSequence.load() >= required) {
+                candidates.push_back(replica.get());
+            }
+        }
+        sort(candidates.begin(), candidates.end(), [](const Replica* a, const Replica* b) {
+            auto rank = [](const Replica* r) {
+                return make_tuple(!r->healthy.load(), r->latencyNanos.load());
+            };
+            return rank(a) < rank(b);
+        });
+
+        string lastError;
+        bool notFound = false;
+        for (Replica* replica : candidates) {
+            auto start = chrono::steady_clock::now();
+            try {
+                Order order = replica->database->findById(id);
+                replica->recordLatency(chrono::steady_clock::now() - start);
+                return order;
+            }
+            catch (const out_of_range& error) {
+                notFound = true;
+                lastError = error.what();
+            }
+            catch (const exception& error) {
+                replica->healthy = false;
+                lastError = error.what();
+            }
+        }
+        if (notFound) {
+            throw out_of_range("Order not found: " + to_string(id));
+        }
+        throw runtime_error("No up-to-date replica could serve order " + to_string(id) +
+            (lastError.empty() ? string() : ": " + lastError));
+    }
+
+    uint64_t getAcknowledgedSequence() const { return acknowledgedSequence.load(); }
+
+    vector<ReplicaStats> getReplicaStats() const {
+        vector<ReplicaStats> stats;
+        for (const auto& replica : replicas) {
+            ReplicaStats entry;
+            entry.type = replica->database->getType();
+            entry.healthy = replica->healthy;
+            entry.appliedWrites = replica->applied;
+            entry.failedWrites = replica->failed;
+            entry.lag = replica->lag();
+            entry.missedWrites = replica->missedCount;
+            entry.appliedSequence = replica->appliedSequence;
+            entry.diverged = replica->diverged;
+            entry.latencyMicros = replica->latencyNanos / 1000;
+            stats.push_back(entry);
+        }
+        return stats;
+    }
+
+    string getType() const override {
+        string type = "Replicated [";
+        for (size_t i = 0; i < replicas.size(); ++i) {
+            type += (i > 0 ? ", " : "") + replicas[i]->database->getType();
+        }
+        return type + "]";
+    }
+};
+
+struct BloomFilterStats {
+    uint64_t lookups = 0;
+    uint64_t avoidedBackendCalls = 0; // Definite miss, dijawab tanpa backend
+    uint64_t falsePositives = 0;      // Filter bilang "mungkin ada", backend bilang tidak
+    size_t bitCount = 0;
+    int hashCount = 0;
+};
+
+// Bloom filter di depan findById: id yang pasti tidak ada (tablet stale, salah ketik)
+// langsung out_of_range tanpa round trip ke backend. Filter diisi saat save;
+// order yang sudah ada sebelumnya di-warm-up lewat add().
+class BloomFilterDatabase : public DatabaseService {
+private:
+    shared_ptr<DatabaseService> inner;
+    size_t bitCount;
+    int hashCount;
+    unique_ptr<atomic<uint64_t>[]> words; // Lock-free: set bit pakai fetch_or
+
+    atomic<uint64_t> lookups{ 0 };
+    atomic<uint64_t> avoided{ 0 };
+    atomic<uint64_t> falsePositives{ 0 };
+
+    // Double hashing: bit ke-i = h1 + i * h2
+    template <typename Visitor>
+    void forEachBit(int id, Visitor&& visit) const {
+        uint64_t hash = mixHash(static_cast<uint32_t>(id));
+        uint64_t h1 = hash & 0xFFFFFFFFULL;
+        uint64_t h2 = (hash >> 32) | 1;
+        for (int i = 0; i < hashCount; ++i) {
+            visit((h1 + i * h2) % bitCount);
+        }
+    }
+
+public:
+    // Ukuran optimal dari expectedOrders + falsePositiveRate, dibatasi maxBytes
+    BloomFilterDatabase(shared_ptr<DatabaseService> db, size_t expectedOrders,
+        double falsePositiveRate = 0.01, size_t maxBytes = 64 * 1024 * 1024)
+        : inner(db) {
+        if (expectedOrders == 0 || falsePositiveRate <= 0.0 || falsePositiveRate >= 1.0 || maxBytes == 0) {
+            throw invalid_argument("Invalid Bloom filter configuration");
+        }
+        const double ln2 = log(2.0);
+        double optimalBits = -static_cast<double>(expectedOrders) * log(falsePositiveRate) / (ln2 * ln2);
+        bitCount = static_cast<size_t>(min(optimalBits, static_cast<double>(maxBytes) * 8.0));
+        bitCount = max<size_t>(64, (bitCount + 63) / 64 * 64);
+        hashCount = static_cast<int>(lround(static_cast<double>(bitCount) / expectedOrders * ln2));
+        hashCount = max(1, min(hashCount, 16));
+
+        words = make_unique<atomic<uint64_t>[]>(bitCount / 64);
+        for (size_t i = 0; i < bitCount / 64; ++i) {
+            words[i].store(0, memory_order_relaxed);
+        }
+    }
+
+    void add(int id) {
+        forEachBit(id, [this](size_t bit) {
+            words[bit / 64].fetch_or(1ULL << (bit % 64), memory_order_relaxed);
+        });
+    }
+
+    bool mightContain(int id) const {
+        bool present = true;
+        forEachBit(id, [this, &present](size_t bit) {
+            if ((words[bit / 64].load(memory_order_relaxed) & (1ULL << (bit % 64))) == 0) {
+                present = false;
+            }
+        });
+        return present;
+    }
+
+    // Bit di-set sebelum backend save, jadi reader tidak pernah dapat false negative
+    void save(const Order& order) override {
+        add(order.getId());
+        inner->save(order);
+    }
+
+    void saveBatch(OrderSpan orders) override {
+        for (const auto& order : orders) {
+            add(order.getId());
+        }
+        inner->saveBatch(orders);
+    }
+
+    Order findById(int id) override {
+        lookups++;
+        if (!mightContain(id)) {
+            avoided++;
+            throw out_of_range("Order not found: " + to_string(id));
+        }
+        try {
+            return inner->findById(id);
+        }
+        catch (const out_of_range&) {
+            falsePositives++;
+            throw;
+        }
+    }
+
+    // Definite miss langsung masuk missing; sisanya satu batch ke backend
+    void findByIds(IdSpan ids, vector<Order>& found, vector<int>& missing) override {
+        vector<int> candidates;
+        for (int id : ids) {
+            if (mightContain(id)) {
+                candidates.push_back(id);
+            }
+            else {
+                missing.push_back(id);
+            }
+        }
+        lookups += ids.size();
+        avoided += ids.size() - candidates.size();
+        if (candidates.empty()) {
+            return;
+        }
+
+        size_t missingBefore = missing.size();
+        inner->findByIds(candidates, found, missing);
+        falsePositives += missing.size() - missingBefore;
+    }
+
+    BloomFilterStats getStats() const {
+        BloomFilterStats stats;
+        stats.lookups = lookups;
+        stats.avoidedBackendCalls = avoided;
+        stats.falsePositives = falsePositives;
+        stats.bitCount = bitCount;
+        stats.hashCount = hashCount;
+        return stats;
+    }
+
+    string getType() const override { return "BloomFiltered " + inner->getType(); }
+};
+
+//  SOLUTION 1: DEPENDENCY INJECTION
+
+// Compile-time "interface check" - pengganti concepts untuk C++17
+template <typename T, typename = void>
+struct IsDatabaseService : false_type {};
+
+template <typename T>
+struct IsDatabaseService<T, void_t<
+    decltype(declval<T&>().save(declval<const Order&>())),
+    decltype(Order(declval<T&>().findById(0))),
+    decltype(string(declval<const T&>().getType()))>> : true_type {};
+
+template <typename T, typename = void>
+struct IsNotificationService : false_type {};
+
+template <typename T>
+struct IsNotificationService<T, void_t<
+    decltype(declval<T&>().send(declval<string_view>())),
+    decltype(string(declval<const T&>().getType()))>> : true_type {};
+
+// Akses seragam ke dependency: object langsung atau lewat shared_ptr
+template <typename T>
+struct ServiceAccess {
+    static T& get(T& service) { return service; }
+    static const T& get(const T& service) { return service; }
+};
+
+template <typename T>
+struct ServiceAccess<shared_ptr<T>> {
+    static T& get(const shared_ptr<T>& service) { return *service; }
+};
+
+// Behaviour restaurant service yang sama untuk runtime dan compile-time dispatch.
+// Dengan Db/Notifier concrete (misal MySQLDatabase), processOrder bisa di-inline penuh.
+template <typename Db, typename Notifier>
+class BasicRestaurantService {
+protected:
+    Db database;
+    Notifier notification;
+    shared_ptr<OutputSink> output;
+
+    using DatabaseType = remove_reference_t<decltype(ServiceAccess<Db>::get(declval<Db&>()))>;
+    using NotificationType = remove_reference_t<decltype(ServiceAccess<Notifier>::get(declval<Notifier&>()))>;
+
+    static_assert(IsDatabaseService<DatabaseType>::value,
+        "Db must provide save(const Order&), findById(int) and getType()");
+    static_assert(IsNotificationService<NotificationType>::value,
+        "Notifier must provide send(string_view) and getType()");
+
+public:
+    BasicRestaurantService(Db db, Notifier notif,
+        shared_ptr<OutputSink> sink = defaultOutputSink())
+        : database(move(db)), notification(move(notif)), output(move(sink)) {
+    }
+
+    void processOrder(const Order& order) {
+        ServiceAccess<Db>::get(database).save(order);
+        ServiceAccess<Notifier>::get(notification).send(
+            renderMessage("Order ", order.getId(), " processed successfully!"));
+        output->writeLine(" Order processed with LOOSE COUPLING (DIP compliant)");
+        output->endOrder();
+    }
+
+    Order getOrder(int id) {
+        return ServiceAccess<Db>::get(database).findById(id);
+    }
+
+    string getConfiguration() const {
+        return ServiceAccess<Db>::get(database).getType() + " + " +
+            ServiceAccess<Notifier>::get(notification).getType();
+    }
+};
+
+// Runtime-polymorphic version: dependency di-inject lewat abstraction
+class GoodRestaurantService
+    : public BasicRestaurantService<shared_ptr<DatabaseService>, shared_ptr<NotificationService>> {
+public:
+    // Constructor Injection - depend on abstractions!
+    GoodRestaurantService(shared_ptr<DatabaseService> db,
+        shared_ptr<NotificationService> notif,
+        shared_ptr<OutputSink> sink = defaultOutputSink())
+        : BasicRestaurantService(db, notif, sink) {
+        output->writeLine(" GoodRestaurantService: Created with "
+            + db->getType() + " + " + notif->getType());
+    }
+};
+
+//  SOLUTION 2: FACTORY PATTERN
+class DatabaseFactory {
+public:
+    static shared_ptr<DatabaseService> createDatabase(const string& type) {
+        if (type == "mysql") {
+            return make_shared<MySQLDatabase>();
+        }
+        else if (type == "postgresql") {
+            return make_shared<PostgreSQLDatabase>();
+        }
+        else if (type == "mongodb") {
+            return make_shared<MongoDatabase>();
+        }
+        else if (type == "memory") {
+            return make_shared<InMemoryDatabase>();
+        }
+        else {
+            throw invalid_argument("Unknown database type: " + type);
+        }
+    }
+
+    // N backend dengan tipe yang sama di belakang satu ShardedDatabase
+    static shared_ptr<DatabaseService> createShardedDatabase(const string& type, size_t shardCount) {
+        if (shardCount == 0) {
+            throw invalid_argument("Shard count must be positive");
+        }
+        vector<shared_ptr<DatabaseService>> shards;
+        for (size_t i = 0; i < shardCount; ++i) {
+            shards.push_back(createDatabase(type));
+        }
+        return make_shared<ShardedDatabase>(shards);
+    }
+};
+
+class NotificationFactory {
+public:
+    static shared_ptr<NotificationService> createNotification(const string& type) {
+        if (type == "email") {
+            return make_shared<EmailNotification>();
+        }
+        else if (type == "sms") {
+            return make_shared<SMSNotification>();
+        }
+        else if (type == "slack") {
+            return make_shared<SlackNotification>();
+        }
+        else {
+            throw invalid_argument("Unknown notification type: " + type);
+        }
+    }
+
+    // Contoh: {"email", "sms", "slack"} untuk order VIP
+    static shared_ptr<NotificationService> createCompositeNotification(const vector<string>& types,
+        chrono::milliseconds timeout = chrono::milliseconds(500)) {
+        vector<shared_ptr<NotificationService>> services;
+        for (const auto& type : types) {
+            services.push_back(createNotification(type));
+        }
+        return make_shared<CompositeNotification>(services, timeout);
+    }
+};
+
+enum class AdmissionPolicy {
+    Block,              // Queue penuh: submitter menunggu sampai ada slot
+    Reject,             // Queue penuh: order baru langsung ditolak
+    ShedLowestPriority  // Queue penuh: buang order prioritas terendah
+};
+
+enum class AdmissionStatus {
+    Accepted,
+    Rejected,      // Queue penuh (atau order kalah prioritas saat shedding)
+    ShuttingDown
+};
+
+struct AdmissionStats {
+    uint64_t submitted = 0;
+    uint64_t accepted = 0;
+    uint64_t rejected = 0;
+    uint64_t shed = 0;            // Order yang sudah diterima lalu dibuang untuk prioritas lebih tinggi
+    uint64_t blockedSubmits = 0;
+    uint64_t processed = 0;
+    uint64_t failed = 0;
+    size_t queueDepth = 0;
+    size_t maxQueueDepth = 0;
+    chrono::microseconds totalQueueTime{ 0 }; // Waktu tunggu di queue, semua order yang diproses
+    chrono::microseconds maxQueueTime{ 0 };
+
+    chrono::microseconds averageQueueTime() const {
+        return processed + failed == 0 ? chrono::microseconds(0)
+            : totalQueueTime / static_cast<int64_t>(processed + failed);
+    }
+};
+
+// Bounded intake queue di depan processOrder. Order diproses worker thread,
+// prioritas tertinggi dulu, FIFO dalam prioritas yang sama.
+class AdmissionQueue {
+public:
+    using OrderHandler = function<void(const Order&)>;
+    using ShedHandler = function<void(const Order&)>;
+
+private:
+    struct Entry {
+        Order order;
+        chrono::steady_clock::time_point enqueuedAt;
+    };
+
+    OrderHandler handler;
+    ShedHandler onShed;
+    AdmissionPolicy policy;
+    size_t capacity;
+    vector<thread> workers;
+
+    mutable mutex queueMutex;
+    condition_variable notEmpty;
+    condition_variable notFull;
+    map<int, deque<Entry>> queue; // priority -> order
+    size_t depth = 0;
+    bool stopping = false;
+    AdmissionStats stats;
+
+    void workerLoop() {
+        while (true) {
+            unique_lock<mutex> lock(queueMutex);
+            notEmpty.wait(lock, [this] { return stopping || depth > 0; });
+            if (depth == 0) {
+                return; // Stopping dan queue sudah kosong (drained)
+            }
+            auto highest = prev(queue.end());
+            Entry entry = move(highest->second.front());
+            highest->second.pop_front();
+            if (highest->second.empty()) {
+                queue.erase(highest);
+            }
+            depth--;
+            lock.unlock();
+            notFull.notify_one();
+
+            auto waited = chrono::duration_cast<chrono::microseconds>(
+                chrono::steady_clock::now() - entry.enqueuedAt);
+            bool succeeded = true;
+            try {
+                handler(entry.order);
+            }
+            catch (const exception&) {
+                succeeded = false;
+            }
+
+            lock.lock();
+            if (succeeded) {
+                stats.processed++;
+            }
+            else {
+                stats.failed++;
+            }
+            stats.totalQueueTime += waited;
+            stats.maxQueueTime = max(stats.maxQueueTime, waited);
+        }
+    }
+
+    // Dipanggil dengan queueMutex terkunci; return order yang dibuang, kalau ada
+    optional<Order> shedLowestLocked(int priority) {
+        auto lowest = queue.begin();
+        if (lowest == queue.end() || lowest->first >= priority) {
+            return nullopt; // Order baru tidak lebih penting dari isi queue
+        }
+        Order victim = move(lowest->second.back().order); // Yang terbaru dibuang duluan
+        lowest->second.pop_back();
+        if (lowest->second.empty()) {
+            queue.erase(lowest);
+        }
+        depth--;
+        stats.shed++;
+        return victim;
+    }
+
+public:
+    AdmissionQueue(OrderHandler orderHandler, size_t queueCapacity,
+        AdmissionPolicy admissionPolicy = AdmissionPolicy::Block,
+        size_t workerCount = 1, ShedHandler shedHandler = nullptr)
+        : handler(move(orderHandler)), onShed(move(shedHandler)),
+        policy(admissionPolicy), capacity(queueCapacity) {
+        if (!handler || workerCount == 0 || queueCapacity == 0) {
+            throw invalid_argument("AdmissionQueue needs a handler, at least one worker and queue slot");
+        }
+        for (size_t i = 0; i < workerCount; ++i) {
+            workers.emplace_back(&AdmissionQueue::workerLoop, this);
+        }
+    }
+
+    ~AdmissionQueue() {
+        shutdown();
+    }
+
+    AdmissionQueue(const AdmissionQueue&) = delete;
+    AdmissionQueue& operator=(const AdmissionQueue&) = delete;
+
+    AdmissionStatus submit(Order order, int priority = 0) {
+        optional<Order> victim;
+        {
+            unique_lock<mutex> lock(queueMutex);
+            stats.submitted++;
+            if (stopping) {
+                stats.rejected++;
+                return AdmissionStatus::ShuttingDown;
+            }
+
+            if (depth >= capacity) {
+                switch (policy) {
+                case AdmissionPolicy::Block:
+                    stats.blockedSubmits++;
+                    notFull.wait(lock, [this] { return stopping || depth < capacity; });
+                    if (stopping) {
+                        stats.rejected++;
+                        return AdmissionStatus::ShuttingDown;
+                    }
+                    break;
+                case AdmissionPolicy::Reject:
+                    stats.rejected++;
+                    return AdmissionStatus::Rejected;
+                case AdmissionPolicy::ShedLowestPriority:
+                    victim = shedLowestLocked(priority);
+                    if (!victim) {
+                        stats.rejected++;
+                        return AdmissionStatus::Rejected;
+                    }
+                    break;
+                }
+            }
+
+            queue[priority].push_back(Entry{ move(order), chrono::steady_clock::now() });
+            depth++;
+            stats.accepted++;
+            stats.maxQueueDepth = max(stats.maxQueueDepth, depth);
+        }
+        notEmpty.notify_one();
+
+        if (victim && onShed) {
+            onShed(*victim); // Di luar lock: handler boleh lambat
+        }
+        return AdmissionStatus::Accepted;
+    }
+
+    // Drain-on-shutdown: order yang sudah diterima tetap diproses
+    void shutdown() {
+        {
+            lock_guard<mutex> lock(queueMutex);
+            if (stopping) {
+                return;
+            }
+            stopping = true;
+        }
+        notEmpty.notify_all();
+        notFull.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    AdmissionStats getStats() const {
+        lock_guard<mutex> lock(queueMutex);
+        AdmissionStats snapshot = stats;
+        snapshot.queueDepth = depth;
+        return snapshot;
+    }
+};
+
+class RestaurantManager {
+private:
+    shared_ptr<GoodRestaurantService> restaurantService;
+    shared_ptr<AdmissionQueue> admission; // Opsional; tanpa ini processOrder sinkron
+    shared_ptr<OutputSink> output;
+
+public:
+    explicit RestaurantManager(shared_ptr<OutputSink> sink = defaultOutputSink())
+        : output(sink) {
+    }
+
+    void initialize(const string& dbType, const string& notificationType) {
+        output->writeLine("  Initializing restaurant with " + dbType + " and " + notificationType);
+
+        auto database = DatabaseFactory::createDatabase(dbType);
+        auto notification = NotificationFactory::createNotification(notificationType);
+
+        // Queue lama terikat ke service lama: order yang sudah diterima di-drain ke
+        // sana, lalu queue dilepas. Panggil enableAdmissionQueue lagi untuk service baru.
+        if (admission) {
+            admission->shutdown();
+            admission.reset();
+        }
+        restaurantService = make_shared<GoodRestaurantService>(database, notification, output);
+    }
+
+    // Semua order lewat sini. Dengan admission queue aktif, order masuk queue dan
+    // status memberi tahu caller kalau order ditolak; tanpa queue diproses sinkron.
+    AdmissionStatus processOrder(const Order& order, int priority = 0) {
+        if (admission) {
+            return admission->submit(order, priority);
+        }
+        if (!restaurantService) {
+            output->writeLine(" Restaurant not initialized!");
+            return AdmissionStatus::Rejected;
+        }
+        restaurantService->processOrder(order);
+        return AdmissionStatus::Accepted;
+    }
+
+    // Pasang bounded queue di depan processOrder (setelah initialize; initialize
+    // berikutnya melepas queue ini). Setelah ini tidak ada jalur sinkron tanpa batas.
+    void enableAdmissionQueue(size_t capacity, AdmissionPolicy policy = AdmissionPolicy::Block,
+        size_t workerCount = 1, AdmissionQueue::ShedHandler onShed = nullptr) {
+        if (!restaurantService) {
+            throw runtime_error("Restaurant not initialized");
+        }
+        auto service = restaurantService;
+        admission = make_shared<AdmissionQueue>(
+            [service](const Order& order) { service->processOrder(order); },
+            capacity, policy, workerCount, move(onShed));
+    }
+
+    AdmissionStats getAdmissionStats() const {
+        return admission ? admission->getStats() : AdmissionStats{};
+    }
+
+    string getConfiguration() const {
+        return restaurantService ? restaurantService->getConfiguration() : "Not initialized";
+    }
+};
+
+//  SOLUTION 3: STRATEGY PATTERN
+
+class PaymentStrategy {
+public:
+    virtual ~PaymentStrategy() = default;
+    virtual void processPayment(Money amount) = 0;
+    virtual bool validatePayment(string_view paymentInfo) = 0;
+    virtual string getPaymentType() const = 0;
+};
+
+class CreditCardStrategy : public PaymentStrategy {
+private:
+    shared_ptr<OutputSink> output;
+
+public:
+    explicit CreditCardStrategy(shared_ptr<OutputSink> sink = defaultOutputSink())
+        : output(sink) {
+    }
+
+    void processPayment(Money amount) override {
+        writeAmountLine(*output, " Processing credit card payment: $", amount);
+    }
+
+    bool validatePayment(string_view paymentInfo) override {
+        return paymentInfo.length() == 16; // Simple validation
+    }
+
+    string getPaymentType() const override { return "Credit Card"; }
+};
+
+class DigitalWalletStrategy : public PaymentStrategy {
+private:
+    shared_ptr<OutputSink> output;
+
+public:
+    explicit DigitalWalletStrategy(shared_ptr<OutputSink> sink = defaultOutputSink())
+        : output(sink) {
+    }
+
+    void processPayment(Money amount) override {
+        writeAmountLine(*output, " Processing digital wallet payment: $", amount);
+    }
+
+    bool validatePayment(string_view paymentInfo) override {
+        return !paymentInfo.empty(); // Simple validation
+    }
+
+    string getPaymentType() const override { return "Digital Wallet"; }
+};
+
+class CashStrategy : public PaymentStrategy {
+private:
+    shared_ptr<OutputSink> output;
+
+public:
+    explicit CashStrategy(shared_ptr<OutputSink> sink = defaultOutputSink())
+        : output(sink) {
+    }
+
+    void processPayment(Money amount) override {
+        writeAmountLine(*output, " Processing cash payment: $", amount);
+    }
+
+    bool validatePayment(string_view paymentInfo) override {
+        return true; // Cash always valid
+    }
+
+    string getPaymentType() const override { return "Cash"; }
+};
+
+class PaymentProcessor {
+private:
+    shared_ptr<PaymentStrategy> strategy;
+    shared_ptr<OutputSink> output;
+
+public:
+    PaymentProcessor(shared_ptr<PaymentStrategy> strat,
+        shared_ptr<OutputSink> sink = defaultOutputSink())
+        : strategy(strat), output(sink) {
+        output->writeLine(" PaymentProcessor initialized with: " + strat->getPaymentType());
+    }
+
+    void setStrategy(shared_ptr<PaymentStrategy> newStrategy) {
+        strategy = newStrategy;
+        output->writeLine(" Payment strategy changed to: " + strategy->getPaymentType());
+    }
+
+    bool processOrderPayment(const Order& order) {
+        output->writeLine(renderMessage(" Processing payment for order: ", order.getId()));
+
+        bool success = strategy->validatePayment(order.getPaymentInfo());
+        if (success) {
+            strategy->processPayment(order.getTotalAmount());
+            output->writeLine(" Payment successful!");
+        }
+        else {
+            output->writeLine(" Payment validation failed!");
+        }
+        output->endOrder();
+        return success;
+    }
+
+    string getCurrentStrategy() const {
+        return strategy->getPaymentType();
+    }
+};
+
+// ==================== CONCURRENT ORDER ENGINE ====================
+
+// Thread pool dengan satu deque per worker. Worker ambil task dari deque sendiri
+// (LIFO, cache-friendly) dan mencuri dari deque worker lain (FIFO) saat kosong.
+class WorkStealingPool {
+private:
+    struct WorkerQueue {
+        mutex queueMutex;
+        deque<function<void()>> tasks;
+    };
+
+    vector<unique_ptr<WorkerQueue>> queues;
+    vector<thread> threads;
+    atomic<size_t> nextQueue{ 0 };
+    atomic<size_t> pending{ 0 };  // Task yang sudah di-submit tapi belum diambil worker
+    atomic<size_t> sleepers{ 0 }; // Worker yang sedang (atau hampir) tidur
+    mutex idleMutex;              // Hanya untuk tidur/bangun, bukan hot path
+    condition_variable idleCondition;
+    bool stopping = false;        // Dilindungi idleMutex
+
+    static thread_local WorkStealingPool* currentPool;
+    static thread_local size_t currentWorker;
+
+    bool tryPop(size_t worker, function<void()>& task) {
+        // Own queue dulu (back), lalu steal dari worker lain (front)
+        for (size_t i = 0; i < queues.size(); ++i) {
+            WorkerQueue& queue = *queues[(worker + i) % queues.size()];
+            lock_guard<mutex> lock(queue.queueMutex);
+            if (queue.tasks.empty()) {
+                continue;
+            }
+            if (i == 0) {
+                task = move(queue.tasks.back());
+                queue.tasks.pop_back();
+            }
+            else {
+                task = move(queue.tasks.front());
+                queue.tasks.pop_front();
+            }
+            return true;
+        }
+        return false;
+    }
+
+    void workerLoop(size_t worker) {
+        currentPool = this;
+        currentWorker = worker;
+
+        while (true) {
+            function<void()> task;
+            if (tryPop(worker, task)) {
+                pending.fetch_sub(1);
+                task();
+                continue;
+            }
+
+            // Daftar sebagai sleeper dulu, baru cek pending: submit() yang melihat
+            // sleepers > 0 akan mengambil idleMutex, jadi wakeup tidak hilang
+            unique_lock<mutex> lock(idleMutex);
+            sleepers.fetch_add(1);
+            idleCondition.wait(lock, [this] { return pending.load() > 0 || stopping; });
+            sleepers.fetch_sub(1);
+            if (stopping && pending.load() == 0) {
+                return;
+            }
+            // pending > 0 tapi queue kosong: task sedang di-push, coba lagi
+        }
+    }
+
+public:
+    explicit WorkStealingPool(size_t threadCount) {
+        if (threadCount == 0) {
+            throw invalid_argument("WorkStealingPool needs at least one thread");
+        }
+        for (size_t i = 0; i < threadCount; ++i) {
+            queues.push_back(make_unique<WorkerQueue>());
+        }
+        for (size_t i = 0; i < threadCount; ++i) {
+            threads.emplace_back(&WorkStealingPool::workerLoop, this, i);
+        }
+    }
+
+    ~WorkStealingPool() {
+        shutdown();
+    }
+
+    void submit(function<void()> task) {
+        // Dari worker thread: push ke queue sendiri; dari luar: round-robin
+        size_t target = currentPool == this
+            ? currentWorker
+            : nextQueue.fetch_add(1, memory_order_relaxed) % queues.size();
+        pending.fetch_add(1); // Sebelum push: worker tidak pernah melihat pending underflow
+        {
+            lock_guard<mutex> lock(queues[target]->queueMutex);
+            queues[target]->tasks.push_back(move(task));
+        }
+        if (sleepers.load() > 0) {
+            { lock_guard<mutex> lock(idleMutex); } // Tunggu worker yang sedang masuk wait()
+            idleCondition.notify_one();
+        }
+    }
+
+    // Selesaikan semua task yang tersisa, lalu join
+    void shutdown() {
+        {
+            lock_guard<mutex> lock(idleMutex);
+            if (stopping) {
+                return;
+            }
+            stopping = true;
+        }
+        idleCondition.notify_all();
+        for (auto& worker : threads) {
+            worker.join();
+        }
+    }
+
+    size_t size() const { return threads.size(); }
+};
+
+thread_local WorkStealingPool* WorkStealingPool::currentPool = nullptr;
+thread_local size_t WorkStealingPool::currentWorker = 0;
+
+// Callback dipanggil sesuai urutan submit, bukan urutan selesai
+using OrderCompletion = function<void(const Order& order, bool success)>;
+
+struct OrderEngineStats {
+    uint64_t submitted = 0;
+    uint64_t succeeded = 0;
+    uint64_t failed = 0;
+    size_t inFlight = 0;
+};
+
+// Multi-producer order intake: processOrder dijalankan paralel di WorkStealingPool
+class OrderEngine {
+private:
+    struct Job {
+        uint64_t sequence;
+        Order order;
+        OrderCompletion onComplete;
+    };
+
+    // Setiap backend punya batas concurrency; job berlebih menunggu di queue backend
+    struct Backend {
+        shared_ptr<GoodRestaurantService> service;
+        size_t maxConcurrent;
+        mutex backendMutex;
+        size_t active = 0;
+        deque<Job> waiting;
+    };
+
+    struct Completion {
+        Order order;
+        bool success;
+        OrderCompletion onComplete;
+    };
+
+    map<string, unique_ptr<Backend>> backends;
+    WorkStealingPool pool;
+
+    mutex engineMutex;
+    condition_variable drained;
+    bool accepting = true;
+    uint64_t nextSequence = 0;
+    OrderEngineStats stats;
+
+    // Ordered completion: hasil yang selesai lebih cepat ditahan sampai gilirannya
+    uint64_t nextToDeliver = 0;
+    map<uint64_t, Completion> completed;
+    bool delivering = false;
+
+    void schedule(Backend& backend, Job job) {
+        pool.submit([this, &backend, job = move(job)]() mutable {
+            run(backend, move(job));
+        });
+    }
+
+    void run(Backend& backend, Job job) {
+        bool success = true;
+        try {
+            backend.service->processOrder(job.order);
+        }
+        catch (const exception&) {
+            success = false;
+        }
+
+        // Slot backend diberikan ke job berikutnya yang menunggu
+        {
+            lock_guard<mutex> lock(backend.backendMutex);
+            if (!backend.waiting.empty()) {
+                Job next = move(backend.waiting.front());
+                backend.waiting.pop_front();
+                schedule(backend, move(next));
+            }
+            else {
+                backend.active--;
+            }
+        }
+
+        complete(job.sequence, Completion{ move(job.order), success, move(job.onComplete) });
+    }
+
+    void complete(uint64_t sequence, Completion completion) {
+        {
+            lock_guard<mutex> lock(engineMutex);
+            completed.emplace(sequence, move(completion));
+            if (delivering) {
+                return; // Thread lain sedang deliver; dia yang akan ambil hasil ini
+            }
+            delivering = true;
+        }
+
+        while (true) {
+            Completion next{ Order(0, "", Money()), false, nullptr };
+            {
+                lock_guard<mutex> lock(engineMutex);
+                auto entry = completed.find(nextToDeliver);
+                if (entry == completed.end()) {
+                    delivering = false;
+                    return;
+                }
+                next = move(entry->second);
+                completed.erase(entry);
+                nextToDeliver++;
+            }
+
+            if (next.onComplete) {
+                try {
+                    next.onComplete(next.order, next.success);
+                }
+                catch (const exception&) {
+                    // Error di callback tidak boleh merusak urutan delivery
+                }
+            }
+
+            {
+                lock_guard<mutex> lock(engineMutex);
+                if (next.success) {
+                    stats.succeeded++;
+                }
+                else {
+                    stats.failed++;
+                }
+                stats.inFlight--;
+            }
+            drained.notify_all();
+        }
+    }
+
+public:
+    explicit OrderEngine(size_t threadCount = max(1u, thread::hardware_concurrency()))
+        : pool(threadCount) {
+    }
+
+    ~OrderEngine() {
+        shutdown();
+    }
+
+    // Daftarkan backend sebelum submit pertama
+    void addBackend(const string& name, shared_ptr<GoodRestaurantService> service,
+        size_t maxConcurrent) {
+        if (maxConcurrent == 0) {
+            throw invalid_argument("Backend concurrency limit must be positive: " + name);
+        }
+        auto backend = make_unique<Backend>();
+        backend->service = service;
+        backend->maxConcurrent = maxConcurrent;
+        backends[name] = move(backend);
+    }
+
+    // Thread-safe untuk banyak producer. Return false kalau engine sudah shutdown.
+    bool submit(const string& backendName, Order order, OrderCompletion onComplete = nullptr) {
+        auto entry = backends.find(backendName);
+        if (entry == backends.end()) {
+            throw invalid_argument("Unknown backend: " + backendName);
+        }
+        Backend& backend = *entry->second;
+
+        Job job{ 0, move(order), move(onComplete) };
+        {
+            lock_guard<mutex> lock(engineMutex);
+            if (!accepting) {
+                return false;
+            }
+            job.sequence = nextSequence++;
+            stats.submitted++;
+            stats.inFlight++;
+        }
+
+        lock_guard<mutex> lock(backend.backendMutex);
+        if (backend.active < backend.maxConcurrent) {
+            backend.active++;
+            schedule(backend, move(job));
+        }
+        else {
+            backend.waiting.push_back(move(job));
+        }
+        return true;
+    }
+
+    // Graceful shutdown: tolak order baru, tunggu semua order selesai, lalu join
+    void shutdown() {
+        {
+            unique_lock<mutex> lock(engineMutex);
+            accepting = false;
+            drained.wait(lock, [this] { return stats.inFlight == 0; });
+        }
+        pool.shutdown();
+    }
+
+    OrderEngineStats getStats() {
+        lock_guard<mutex> lock(engineMutex);
+        return stats;
+    }
+
+    size_t getThreadCount() const { return pool.size(); }
+};
+
+// ==================== MOCK CLASSES FOR TESTING ====================
+class MockDatabase : public DatabaseService {
+private:
+    shared_ptr<OutputSink> output;
+
+public:
+    explicit MockDatabase(shared_ptr<OutputSink> sink = defaultOutputSink())
+        : output(sink) {
+    }
+
+    void save(const Order& order) override {
+        output->writeLine(" MOCK DATABASE: Save called for order " + to_string(order.getId()));
+    }
+
+    Order findById(int id) override {
+        return Order(id, "Mock Order", Money());
+    }
+
+    string getType() const override { return "Mock Database"; }
+};
+
+class MockNotification : public NotificationService {
+private:
+    shared_ptr<OutputSink> output;
+
+public:
+    explicit MockNotification(shared_ptr<OutputSink> sink = defaultOutputSink())
+        : output(sink) {
+    }
+
+    void send(string_view message) override {
+        output->writeLine(string(" MOCK NOTIFICATION: ").append(message));
+    }
+
+    string getType() const override { return "Mock Notification"; }
+};
+
+// Mock dengan latency buatan - mensimulasikan provider notifikasi yang lambat
+class SlowNotification : public NotificationService {
+private:
+    chrono::microseconds delay;
+    atomic<uint64_t> sent{ 0 };
+
+public:
+    explicit SlowNotification(chrono::microseconds latency) : delay(latency) {}
+
+    void send(string_view) override {
+        this_thread::sleep_for(delay);
+        sent.fetch_add(1, memory_order_relaxed);
+    }
+
+    uint64_t getSent() const { return sent.load(memory_order_relaxed); }
+
+    string getType() const override { return "Slow Notification"; }
+};
+
+// Provider yang sedang down: send() gagal sampai setDown(false)
+class OutageNotification : public NotificationService {
+private:
+    atomic<bool> down{ true };
+    atomic<uint64_t> delivered{ 0 };
+
+public:
+    void send(string_view) override {
+        if (down.load()) {
+            throw runtime_error("provider unavailable");
+        }
+        delivered.fetch_add(1, memory_order_relaxed);
+    }
+
+    void setDown(bool isDown) { down = isDown; }
+    uint64_t getDelivered() const { return delivered.load(memory_order_relaxed); }
+
+    string getType() const override { return "Outage Notification"; }
+};
+
+// Mock backend dengan latency buatan per round trip; data disimpan di InMemoryDatabase
+class SlowDatabase : public DatabaseService {
+private:
+    chrono::microseconds delay;
+    chrono::microseconds perRow; // Kerja server per row, di atas latency round trip
+    InMemoryDatabase store;
+    atomic<uint64_t> roundTrips{ 0 };
+
+    void roundTrip(size_t rows = 1) {
+        roundTrips.fetch_add(1, memory_order_relaxed);
+        this_thread::sleep_for(delay + perRow * static_cast<long long>(rows));
+    }
+
+public:
+    explicit SlowDatabase(chrono::microseconds latency, chrono::microseconds rowCost = chrono::microseconds(0))
+        : delay(latency), perRow(rowCost) {
+    }
+
+    void save(const Order& order) override {
+        roundTrip();
+        store.save(order);
+    }
+
+    void saveBatch(OrderSpan orders) override {
+        roundTrip(orders.size());
+        store.saveBatch(orders);
+    }
+
+    Order findById(int id) override {
+        roundTrip();
+        return store.findById(id);
+    }
+
+    void findByIds(IdSpan ids, vector<Order>& found, vector<int>& missing) override {
+        roundTrip(ids.size());
+        store.findByIds(ids, found, missing);
+    }
+
+    uint64_t getRoundTrips() const { return roundTrips.load(memory_order_relaxed); }
+
+    string getType() const override { return "Slow Database"; }
+};
+
+// Sink yang hanya menghitung baris - satu baris = satu statement/round trip ke backend
+class CountingSink : public OutputSink {
+private:
+    atomic<uint64_t> lines{ 0 };
+
+public:
+    void writeLine(string_view) override {
+        lines.fetch_add(1, memory_order_relaxed);
+    }
+
+    uint64_t getLines() const { return lines.load(memory_order_relaxed); }
+};
+
+// ==================== DEMO FUNCTIONS ====================
+
+void printSeparator(const string& title) {
+    cout << "\n" << string(60, '=') << endl;
+    cout << "  " << title << endl;
+    cout << string(60, '=') << endl;
+}
+
+void printSubSeparator(const string& title) {
+    cout << "\n" << string(40, '-') << endl;
+    cout << "  " << title << endl;
+    cout << string(40, '-') << endl;
+}
+
+void demonstrateProblem() {
+    printSubSeparator(" PROBLEM: DIP Violation Example");
+
+    cout << "Mari kita lihat kode yang melanggar DIP:" << endl;
+    cout << "- RestaurantService depend langsung ke MySQLDatabase" << endl;
+    cout << "- RestaurantService depend langsung ke EmailNotification" << endl;
+    cout << "- Hard coded dependencies di constructor" << endl << endl;
+
+    BadRestaurantService badService;
+    Order order1(1, "Nasi Gudeg Special", Money(35, 0));
+    badService.processOrder(order1);
+
+    cout << "\n Masalah:" << endl;
+    cout << "   1. Sulit ganti database (MySQL ke PostgreSQL)" << endl;
+    cout << "   2. Sulit ganti notification (Email ke SMS)" << endl;
+    cout << "   3. Sulit testing (tidak bisa mock)" << endl;
+    cout << "   4. Tight coupling = maintenance nightmare!" << endl;
+}
+
+void demonstrateDependencyInjection() {
+    printSubSeparator(" SOLUTION 1: Dependency Injection");
+
+    cout << "Dependency Injection: Inject dependencies dari luar!" << endl;
+    cout << "- Depend on abstractions (interfaces)" << endl;
+    cout << "- Constructor injection" << endl;
+    cout << "- Loose coupling achieved!" << endl << endl;
+
+    // MySQL + Email
+    auto mysqlDb = make_shared<MySQLDatabase>();
+    auto emailNotif = make_shared<EmailNotification>();
+    GoodRestaurantService service1(mysqlDb, emailNotif);
+
+    Order order2(2, "Sate Ayam Madura", Money(28, 50));
+    service1.processOrder(order2);
+
+    cout << "\n Easy to switch implementations:" << endl;
+
+    // PostgreSQL + SMS  
+    auto postgresDb = make_shared<PostgreSQLDatabase>();
+    auto smsNotif = make_shared<SMSNotification>();
+    GoodRestaurantService service2(postgresDb, smsNotif);
+
+    Order order3(3, "Rendang Padang", Money(42, 0));
+    service2.processOrder(order3);
+
+    cout << "\n Benefits:" << endl;
+    cout << "    Flexible - mudah ganti implementation" << endl;
+    cout << "    Testable - bisa inject mock objects" << endl;
+    cout << "    Maintainable - perubahan terisolasi" << endl;
+}
+
+void demonstrateFactoryPattern() {
+    printSubSeparator(" SOLUTION 2: Factory Pattern");
+
+    cout << "Factory Pattern: Create objects tanpa specify exact class" << endl;
+    cout << "- Configuration-based object creation" << endl;
+    cout << "- Easy to add new implementations" << endl;
+    cout << "- Centralized object creation logic" << endl << endl;
+
+    RestaurantManager manager;
+
+    // MongoDB + Slack
+    manager.initialize("mongodb", "slack");
+    Order order4(4, "Gado-gado Jakarta", Money(22, 0));
+    manager.processOrder(order4);
+
+    cout << "\n Easy configuration switch:" << endl;
+
+    // PostgreSQL + Email
+    manager.initialize("postgresql", "email");
+    Order order5(5, "Bakso Malang", Money(18, 50));
+    manager.processOrder(order5);
+
+    cout << "\n Real-world usage:" << endl;
+    cout << "   - Load from config file: database.type=mysql" << endl;
+    cout << "   - Environment variables: NOTIF_TYPE=slack" << endl;
+    cout << "   - Runtime configuration changes" << endl;
+}
+
+void demonstrateStrategyPattern() {
+    printSubSeparator(" SOLUTION 3: Strategy Pattern");
+
+    cout << "Strategy Pattern: Family of algorithms yang interchangeable" << endl;
+    cout << "- Runtime algorithm switching" << endl;
+    cout << "- Encapsulate algorithm families" << endl;
+    cout << "- Open/Closed principle compliance" << endl << endl;
+
+    Order order6(6, "Ayam Bakar Taliwang", Money(45, 0));
+
+    // Credit Card Payment
+    auto creditCardStrategy = make_shared<CreditCardStrategy>();
+    PaymentProcessor processor(creditCardStrategy);
+
+    order6.setPaymentInfo("credit_card", "1234567890123456");
+    processor.processOrderPayment(order6);
+
+    cout << "\n Runtime strategy switching:" << endl;
+
+    // Digital Wallet Payment
+    auto walletStrategy = make_shared<DigitalWalletStrategy>();
+    processor.setStrategy(walletStrategy);
+    order6.setPaymentInfo("wallet", "wallet123");
+    processor.processOrderPayment(order6);
+
+    // Cash Payment
+    auto cashStrategy = make_shared<CashStrategy>();
+    processor.setStrategy(cashStrategy);
+    order6.setPaymentInfo("cash", "");
+    processor.processOrderPayment(order6);
+
+    cout << "\n Use cases:" << endl;
+    cout << "   - Payment methods (Credit Card, Wallet, Cash)" << endl;
+    cout << "   - Sorting algorithms (QuickSort, MergeSort)" << endl;
+    cout << "   - Compression algorithms (ZIP, RAR, 7Z)" << endl;
+}
+
+void demonstrateTesting() {
+    printSubSeparator(" TESTING: Easy Mocking with DIP");
+
+    cout << "DIP membuat testing menjadi sangat mudah!" << endl;
+    cout << "- Mock objects untuk isolate testing" << endl;
+    cout << "- No external dependencies needed" << endl;
+    cout << "- Fast and reliable unit tests" << endl << endl;
+
+    auto mockDb = make_shared<MockDatabase>();
+    auto mockNotif = make_shared<MockNotification>();
+    GoodRestaurantService testService(mockDb, mockNotif);
+
+    Order testOrder(999, "Test Order", Money(99, 99));
+    testService.processOrder(testOrder);
+
+    cout << "\n Testing benefits:" << endl;
+    cout << "    No database connection needed" << endl;
+    cout << "    No email service needed" << endl;
+    cout << "    Fast test execution" << endl;
+    cout << "    Predictable test results" << endl;
+}
+
+void demonstrateBenefits() {
+    printSubSeparator("🌟 BENEFITS SUMMARY");
+
+    cout << "Dependency Inversion Principle memberikan:" << endl << endl;
+
+    cout << " FLEXIBILITY:" << endl;
+    cout << "   - Mudah ganti implementation tanpa ubah client code" << endl;
+    cout << "   - Support multiple implementations simultaneously" << endl << endl;
+
+    cout << " TESTABILITY:" << endl;
+    cout << "   - Easy mocking untuk unit testing" << endl;
+    cout << "   - Isolated testing tanpa external dependencies" << endl << endl;
+
+    cout << " EXTENSIBILITY:" << endl;
+    cout << "   - Tambah fitur baru tanpa ubah existing code" << endl;
+    cout << "   - Open/Closed principle compliance" << endl << endl;
+
+    cout << " MAINTAINABILITY:" << endl;
+    cout << "   - Perubahan terisolasi per module" << endl;
+    cout << "   - Reduced coupling = easier maintenance" << endl << endl;
+
+    cout << " TEAM PRODUCTIVITY:" << endl;
+    cout << "   - Parallel development dengan interfaces" << endl;
+    cout << "   - Clear separation of concerns" << endl << endl;
+
+    cout << " DIP Quote:" << endl;
+    cout << "\"True strength comes from flexibility." << endl;
+    cout << " Like bamboo that bends but never breaks.\" 🎋" << endl;
+}
+
+// ==================== PERFORMANCE DEMOS ====================
+// Timing run kecil untuk setiap fitur performa. Angka absolut tergantung mesin;
+// yang penting perbandingan antar varian dalam satu run.
+
+// Counter alokasi heap: global operator new diganti supaya demo bisa membuktikan
+// path yang allocation-free (operator new[] default meneruskan ke sini)
+atomic<uint64_t> heapAllocationCount{ 0 };
+
+void* operator new(size_t size) {
+    heapAllocationCount.fetch_add(1, memory_order_relaxed);
+    if (void* memory = malloc(size == 0 ? 1 : size)) {
+        return memory;
+    }
+    throw bad_alloc();
+}
+
+// Versi nothrow (dipakai mis. buffer sementara stable_sort) juga diganti, supaya
+// semua alokasi terhitung dan selalu berpasangan malloc/free
+void* operator new(size_t size, const nothrow_t&) noexcept {
+    heapAllocationCount.fetch_add(1, memory_order_relaxed);
+    return malloc(size == 0 ? 1 : size);
+}
+
+// noinline: kalau di-inline, GCC melihat free() untuk pointer dari operator new
+// dan memberi warning -Wmismatched-new-delete
+[[gnu::noinline]] void operator delete(void* memory) noexcept {
+    free(memory);
+}
+
+[[gnu::noinline]] void operator delete(void* memory, size_t) noexcept {
+    free(memory);
+}
+
+[[gnu::noinline]] void operator delete(void* memory, const nothrow_t&) noexcept {
+    free(memory);
+}
+
+// Jumlah alokasi heap selama body berjalan (hanya akurat kalau thread lain diam)
+template <typename Fn>
+uint64_t countAllocations(Fn&& body) {
+    uint64_t before = heapAllocationCount.load(memory_order_relaxed);
+    body();
+    return heapAllocationCount.load(memory_order_relaxed) - before;
+}
+
+// Jumlah check demo yang gagal; main() return non-zero kalau ada yang gagal
+int failedDemoChecks = 0;
+
+// Path yang dijanjikan allocation-free: alokasi > 0 dilaporkan sebagai FAILED
+void expectNoAllocations(const string& label, uint64_t allocations) {
+    if (allocations == 0) {
+        cout << "  " << label << ": 0 heap allocations (allocation-free)" << endl;
+        return;
+    }
+    failedDemoChecks++;
+    cerr << "  FAILED: " << label << ": " << allocations << " heap allocations, expected 0" << endl;
+}
+
+template <typename Fn>
+double measureMillis(Fn&& body) {
+    auto start = chrono::steady_clock::now();
+    body();
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+long long perSecond(size_t count, double millis) {
+    return millis > 0 ? static_cast<long long>(count * 1000.0 / millis) : 0;
+}
+
+vector<Order> makeDemoOrders(int count, int firstId = 1) {
+    vector<Order> orders;
+    orders.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        orders.emplace_back(firstId + i, "Nasi Goreng #" + to_string(i), Money::fromCents(1500 + i % 5000));
+    }
+    return orders;
+}
+
+void demonstrateBatchSave() {
+    printSubSeparator(" PERFORMANCE: Batch Save");
+
+    // In-process: biaya membangun statement saja, tanpa network
+    const int orderCount = 16384;
+    vector<Order> orders = makeDemoOrders(orderCount);
+
+    auto perOrderSink = make_shared<CountingSink>();
+    MySQLDatabase perOrderDb(perOrderSink);
+    double perOrderMillis = measureMillis([&] {
+        for (const auto& order : orders) {
+            perOrderDb.save(order);
+        }
+    });
+    cout << "  save() per order: " << perSecond(orderCount, perOrderMillis) << " orders/s in-process, "
+        << perOrderSink->getLines() << " statements" << endl;
+
+    for (size_t batchSize : { 1, 16, 256, 4096 }) {
+        auto sink = make_shared<CountingSink>();
+        MySQLDatabase db(sink);
+        OrderSpan all(orders);
+        double millis = measureMillis([&] {
+            for (size_t start = 0; start < all.size(); start += batchSize) {
+                db.saveBatch(all.subspan(start, batchSize));
+            }
+        });
+        cout << "  saveBatch(" << batchSize << "): " << perSecond(orderCount, millis) << " orders/s in-process, "
+            << sink->getLines() << " statements" << endl;
+    }
+
+    // Dengan network: SlowDatabase menambah latency nyata per round trip
+    const int remoteCount = 512;
+    const auto roundTripLatency = chrono::microseconds(500);
+    OrderSpan remoteOrders = OrderSpan(orders).subspan(0, remoteCount);
+
+    SlowDatabase perOrderRemote(roundTripLatency);
+    double perOrderRemoteMillis = measureMillis([&] {
+        for (const auto& order : remoteOrders) {
+            perOrderRemote.save(order);
+        }
+    });
+    cout << "  save() per order, " << roundTripLatency.count() << " us round trips: "
+        << perSecond(remoteCount, perOrderRemoteMillis) << " orders/s, "
+        << perOrderRemote.getRoundTrips() << " round trips" << endl;
+
+    for (size_t batchSize : { 16, 256 }) {
+        SlowDatabase remote(roundTripLatency);
+        double millis = measureMillis([&] {
+            for (size_t start = 0; start < remoteOrders.size(); start += batchSize) {
+                remote.saveBatch(remoteOrders.subspan(start, batchSize));
+            }
+        });
+        cout << "  saveBatch(" << batchSize << "), " << roundTripLatency.count() << " us round trips: "
+            << perSecond(remoteCount, millis) << " orders/s, "
+            << remote.getRoundTrips() << " round trips" << endl;
+    }
+}
+
+// Nilai persentil (0-100) dari sampel latency; sampel diurutkan di tempat
+double percentile(vector<double>& samples, double rank) {
+    if (samples.empty()) {
+        return 0;
+    }
+    sort(samples.begin(), samples.end());
+    size_t index = static_cast<size_t>(rank / 100.0 * (samples.size() - 1));
+    return samples[index];
+}
+
+void demonstrateAsyncNotification() {
+    printSubSeparator(" PERFORMANCE: Async Notification");
+
+    const int orderCount = 200;
+    const auto notifierLatency = chrono::microseconds(2000);
+    vector<Order> orders = makeDemoOrders(orderCount);
+    auto sink = make_shared<NullSink>();
+
+    auto measureOrders = [&](GoodRestaurantService& service) {
+        vector<double> latencies;
+        for (const auto& order : orders) {
+            latencies.push_back(measureMillis([&] { service.processOrder(order); }));
+        }
+        return latencies;
+    };
+
+    auto slowSync = make_shared<SlowNotification>(notifierLatency);
+    GoodRestaurantService syncService(make_shared<MockDatabase>(sink), slowSync, sink);
+    vector<double> syncLatencies = measureOrders(syncService);
+
+    auto slowAsync = make_shared<SlowNotification>(notifierLatency);
+    auto async = make_shared<AsyncNotification>(slowAsync, 4, 256);
+    GoodRestaurantService asyncService(make_shared<MockDatabase>(sink), async, sink);
+    vector<double> asyncLatencies = measureOrders(asyncService);
+    double drainMillis = measureMillis([&] { async->shutdown(); });
+
+    AsyncNotificationStats stats = async->getStats();
+    cout << "  notifier latency " << notifierLatency.count() / 1000.0 << " ms, " << orderCount << " orders" << endl;
+    cout << "  sync : p50 " << percentile(syncLatencies, 50) << " ms, p99 " << percentile(syncLatencies, 99) << " ms" << endl;
+    cout << "  async: p50 " << percentile(asyncLatencies, 50) << " ms, p99 " << percentile(asyncLatencies, 99)
+        << " ms (4 workers, max queue depth " << stats.maxQueueDepth << ", drained in "
+        << static_cast<long long>(drainMillis) << " ms, dispatched " << stats.dispatched << ")" << endl;
+}
+
+// Id dengan distribusi Zipf (exponent s): sedikit order "panas" dibaca berulang-ulang
+vector<int> zipfIds(size_t count, int universe, double exponent, uint64_t seed = 42) {
+    vector<double> cumulative(universe);
+    double total = 0;
+    for (int rank = 0; rank < universe; ++rank) {
+        total += 1.0 / pow(rank + 1, exponent);
+        cumulative[rank] = total;
+    }
+
+    mt19937_64 random(seed);
+    uniform_real_distribution<double> uniform(0, total);
+    vector<int> ids;
+    ids.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        auto rank = lower_bound(cumulative.begin(), cumulative.end(), uniform(random)) - cumulative.begin();
+        ids.push_back(static_cast<int>(rank) + 1);
+    }
+    return ids;
+}
+
+void demonstrateReadThroughCache() {
+    printSubSeparator(" PERFORMANCE: Read-through LRU Cache");
+
+    const int orderCount = 10000;
+    const size_t lookupCount = 5000;
+    auto backend = make_shared<SlowDatabase>(chrono::microseconds(50));
+    backend->saveBatch(makeDemoOrders(orderCount));
+    vector<int> ids = zipfIds(lookupCount, orderCount, 1.0);
+
+    uint64_t directTrips = backend->getRoundTrips();
+    double directMillis = measureMillis([&] {
+        for (int id : ids) {
+            backend->findById(id);
+        }
+    });
+    directTrips = backend->getRoundTrips() - directTrips;
+
+    CachingDatabase cache(backend, 256 * 1024);
+    uint64_t cachedTrips = backend->getRoundTrips();
+    double cachedMillis = measureMillis([&] {
+        for (int id : ids) {
+            cache.findById(id);
+        }
+    });
+    cachedTrips = backend->getRoundTrips() - cachedTrips;
+
+    CacheStats stats = cache.getStats();
+    cout << "  " << lookupCount << " Zipf(1.0) lookups over " << orderCount << " orders, backend 50 us/round trip" << endl;
+    cout << "  direct : " << perSecond(lookupCount, directMillis) << " lookups/s, " << directTrips << " round trips" << endl;
+    cout << "  cached : " << perSecond(lookupCount, cachedMillis) << " lookups/s, " << cachedTrips << " round trips, hit rate "
+        << stats.hits * 100 / max<uint64_t>(1, stats.hits + stats.misses) << "%, "
+        << stats.evictions << " evictions, " << stats.bytes / 1024 << " KB cached" << endl;
+}
+
+// Dispatch lewat std::variant: backend tetap dipilih saat runtime, tapi tanpa virtual call
+using AnyDatabase = variant<MySQLDatabase, PostgreSQLDatabase, MongoDatabase>;
+using AnyNotification = variant<EmailNotification, SMSNotification, SlackNotification>;
 
-    // MySQL + Email
-    auto mysqlDb = make_shared<MySQLDatabase>();
-    auto emailNotif = make_shared<EmailNotification>();
-    GoodRestaurantService service1(mysqlDb, emailNotif);
+struct VariantDatabase {
+    AnyDatabase backend;
 
-    Order order2(2, "Sate Ayam Madura", 28.50);
-    service1.processOrder(order2);
+    void save(const Order& order) { visit([&](auto& db) { db.save(order); }, backend); }
+    Order findById(int id) { return visit([&](auto& db) { return db.findById(id); }, backend); }
+    string getType() const { return visit([](const auto& db) { return db.getType(); }, backend); }
+};
 
-    cout << "\n Easy to switch implementations:" << endl;
+struct VariantNotification {
+    AnyNotification channel;
 
-    // PostgreSQL + SMS  
-    auto postgresDb = make_shared<PostgreSQLDatabase>();
-    auto smsNotif = make_shared<SMSNotification>();
-    GoodRestaurantService service2(postgresDb, smsNotif);
+    void send(string_view message) { visit([&](auto& notifier) { notifier.send(message); }, channel); }
+    string getType() const { return visit([](const auto& notifier) { return notifier.getType(); }, channel); }
+};
 
-    Order order3(3, "Rendang Padang", 42.00);
-    service2.processOrder(order3);
+template <typename Service>
+double nanosPerOrder(Service& service, const vector<Order>& orders) {
+    double millis = measureMillis([&] {
+        for (const auto& order : orders) {
+            service.processOrder(order);
+        }
+    });
+    return millis * 1e6 / orders.size();
+}
 
-    cout << "\n Benefits:" << endl;
-    cout << "    Flexible - mudah ganti implementation" << endl;
-    cout << "    Testable - bisa inject mock objects" << endl;
-    cout << "    Maintainable - perubahan terisolasi" << endl;
+template <typename Db, typename Notifier>
+void compareDispatch(const vector<Order>& orders) {
+    auto sink = make_shared<NullSink>();
+    GoodRestaurantService virtualService(make_shared<Db>(sink), make_shared<Notifier>(sink), sink);
+    BasicRestaurantService<Db, Notifier> templateService{ Db(sink), Notifier(sink), sink };
+    BasicRestaurantService<VariantDatabase, VariantNotification> variantService(
+        VariantDatabase{ Db(sink) }, VariantNotification{ Notifier(sink) }, sink);
+
+    cout << "  " << templateService.getConfiguration() << ": virtual "
+        << static_cast<int>(nanosPerOrder(virtualService, orders)) << " ns, template "
+        << static_cast<int>(nanosPerOrder(templateService, orders)) << " ns, variant "
+        << static_cast<int>(nanosPerOrder(variantService, orders)) << " ns" << endl;
 }
 
-void demonstrateFactoryPattern() {
-    printSubSeparator(" SOLUTION 2: Factory Pattern");
+template <typename Db>
+void compareDispatchForDatabase(const vector<Order>& orders) {
+    compareDispatch<Db, EmailNotification>(orders);
+    compareDispatch<Db, SMSNotification>(orders);
+    compareDispatch<Db, SlackNotification>(orders);
+}
 
-    cout << "Factory Pattern: Create objects tanpa specify exact class" << endl;
-    cout << "- Configuration-based object creation" << endl;
-    cout << "- Easy to add new implementations" << endl;
-    cout << "- Centralized object creation logic" << endl << endl;
+void demonstrateCompileTimeDispatch() {
+    printSubSeparator(" PERFORMANCE: Virtual vs Template vs Variant Dispatch");
 
-    RestaurantManager manager;
+    vector<Order> orders = makeDemoOrders(50000);
+    cout << "  processOrder per order (NullSink), " << orders.size() << " orders:" << endl;
+    compareDispatchForDatabase<MySQLDatabase>(orders);
+    compareDispatchForDatabase<PostgreSQLDatabase>(orders);
+    compareDispatchForDatabase<MongoDatabase>(orders);
+}
 
-    // MongoDB + Slack
-    manager.initialize("mongodb", "slack");
-    Order order4(4, "Gado-gado Jakarta", 22.00);
-    manager.processOrder(order4);
+void demonstrateColumnarStore() {
+    printSubSeparator(" PERFORMANCE: Columnar OrderTable");
 
-    cout << "\n Easy configuration switch:" << endl;
+    const int orderCount = 500000;
+    vector<Order> orders = makeDemoOrders(orderCount);
+    for (size_t i = 0; i < orders.size(); i += 3) {
+        orders[i].setPaymentInfo("cash", "");
+    }
 
-    // PostgreSQL + Email
-    manager.initialize("postgresql", "email");
-    Order order5(5, "Bakso Malang", 18.50);
-    manager.processOrder(order5);
+    OrderTable table;
+    double buildMillis = measureMillis([&] {
+        table.reserve(orders.size(), orders.size() * 20);
+        for (const auto& order : orders) {
+            table.append(order);
+        }
+    });
 
-    cout << "\n Real-world usage:" << endl;
-    cout << "   - Load from config file: database.type=mysql" << endl;
-    cout << "   - Environment variables: NOTIF_TYPE=slack" << endl;
-    cout << "   - Runtime configuration changes" << endl;
+    // Scan yang sama dua kali: array-of-structs vs kolom contiguous
+    Money rowTotal;
+    size_t rowCash = 0;
+    double rowMillis = measureMillis([&] {
+        for (const auto& order : orders) {
+            rowTotal += order.getTotalAmount();
+            rowCash += order.getPaymentType() == "cash" ? 1 : 0;
+        }
+    });
+
+    Money columnTotal;
+    size_t columnCash = 0;
+    double columnMillis = measureMillis([&] {
+        columnTotal = table.totalAmount();
+        const auto& types = table.getPaymentTypes();
+        columnCash = static_cast<size_t>(count(types.begin(), types.end(), PaymentTypeCode::Cash));
+    });
+
+    cout << "  " << orderCount << " orders, table built in " << static_cast<long long>(buildMillis) << " ms" << endl;
+    cout << "  vector<Order> scan: " << rowMillis << " ms (total $" << rowTotal << ", " << rowCash << " cash)" << endl;
+    cout << "  OrderTable scan   : " << columnMillis << " ms (total $" << columnTotal << ", " << columnCash << " cash)" << endl;
 }
 
-void demonstrateStrategyPattern() {
-    printSubSeparator(" SOLUTION 3: Strategy Pattern");
+void demonstrateAllocationFreePayment() {
+    printSubSeparator(" PERFORMANCE: Allocation-free Payment Path");
 
-    cout << "Strategy Pattern: Family of algorithms yang interchangeable" << endl;
-    cout << "- Runtime algorithm switching" << endl;
-    cout << "- Encapsulate algorithm families" << endl;
-    cout << "- Open/Closed principle compliance" << endl << endl;
+    auto sink = make_shared<NullSink>();
+    PaymentProcessor processor(make_shared<CreditCardStrategy>(sink), sink);
+    Order order(7, "Es Teh", Money(5, 0)); // String pendek: muat di SSO
+    order.setPaymentInfo("credit_card", "1234567890123456");
 
-    Order order6(6, "Ayam Bakar Taliwang", 45.00);
+    const int paymentCount = 10000;
+    processor.processOrderPayment(order); // Warm-up
+    uint64_t allocations = countAllocations([&] {
+        for (int i = 0; i < paymentCount; ++i) {
+            processor.processOrderPayment(order);
+        }
+    });
+    expectNoAllocations(to_string(paymentCount) + " x processOrderPayment", allocations);
+}
 
-    // Credit Card Payment
-    auto creditCardStrategy = make_shared<CreditCardStrategy>();
-    PaymentProcessor processor(creditCardStrategy);
+void demonstrateOrderFormatting() {
+    printSubSeparator(" PERFORMANCE: Order Formatting");
 
-    order6.setPaymentInfo("credit_card", "1234567890123456");
-    processor.processOrderPayment(order6);
+    vector<Order> orders = makeDemoOrders(100000);
+    size_t totalBytes = 0;
 
-    cout << "\n Runtime strategy switching:" << endl;
+    uint64_t toStringAllocations = 0;
+    double toStringMillis = measureMillis([&] {
+        toStringAllocations = countAllocations([&] {
+            for (const auto& order : orders) {
+                totalBytes += order.toString().size();
+            }
+        });
+    });
 
-    // Digital Wallet Payment
-    auto walletStrategy = make_shared<DigitalWalletStrategy>();
-    processor.setStrategy(walletStrategy);
-    order6.setPaymentInfo("wallet", "wallet123");
-    processor.processOrderPayment(order6);
+    char buffer[256];
+    uint64_t formatToAllocations = 0;
+    double formatToMillis = measureMillis([&] {
+        formatToAllocations = countAllocations([&] {
+            for (const auto& order : orders) {
+                char* end = order.formatTo(buffer, buffer + sizeof(buffer));
+                totalBytes += end != nullptr ? static_cast<size_t>(end - buffer) : 0;
+            }
+        });
+    });
 
-    // Cash Payment
-    auto cashStrategy = make_shared<CashStrategy>();
-    processor.setStrategy(cashStrategy);
-    order6.setPaymentInfo("cash", "");
-    processor.processOrderPayment(order6);
+    string bulk;
+    uint64_t bulkAllocations = 0;
+    double bulkMillis = measureMillis([&] {
+        bulkAllocations = countAllocations([&] { formatOrders(orders, bulk); });
+    });
+    totalBytes += bulk.size();
 
-    cout << "\n Use cases:" << endl;
-    cout << "   - Payment methods (Credit Card, Wallet, Cash)" << endl;
-    cout << "   - Sorting algorithms (QuickSort, MergeSort)" << endl;
-    cout << "   - Compression algorithms (ZIP, RAR, 7Z)" << endl;
+    cout << "  " << orders.size() << " orders (" << totalBytes / 3 / 1024 << " KB of text per run)" << endl;
+    cout << "  toString()     : " << toStringMillis << " ms, " << toStringAllocations << " allocations" << endl;
+    cout << "  formatTo()     : " << formatToMillis << " ms, " << formatToAllocations << " allocations" << endl;
+    cout << "  formatOrders() : " << bulkMillis << " ms, " << bulkAllocations << " allocations" << endl;
 }
 
-void demonstrateTesting() {
-    printSubSeparator(" TESTING: Easy Mocking with DIP");
+void demonstrateMoneyAggregation() {
+    printSubSeparator(" PERFORMANCE: Fixed-point Money Aggregation");
 
-    cout << "DIP membuat testing menjadi sangat mudah!" << endl;
-    cout << "- Mock objects untuk isolate testing" << endl;
-    cout << "- No external dependencies needed" << endl;
-    cout << "- Fast and reliable unit tests" << endl << endl;
+    // 1M item $0.10: double menumpuk rounding error, Money tetap exact
+    const size_t itemCount = 1000000;
+    vector<Money> amounts(itemCount, Money(0, 10));
+    vector<double> doubles(itemCount, 0.10);
 
-    auto mockDb = make_shared<MockDatabase>();
-    auto mockNotif = make_shared<MockNotification>();
-    GoodRestaurantService testService(mockDb, mockNotif);
+    Money total, lowest, highest;
+    double moneyMillis = measureMillis([&] {
+        total = sumMoney(amounts.data(), amounts.size());
+    });
+    double minMaxMillis = measureMillis([&] {
+        lowest = minMoney(amounts.data(), amounts.size());
+        highest = maxMoney(amounts.data(), amounts.size());
+    });
 
-    Order testOrder(999, "Test Order", 99.99);
-    testService.processOrder(testOrder);
+    double doubleTotal = 0;
+    double doubleMillis = measureMillis([&] {
+        for (double value : doubles) {
+            doubleTotal += value;
+        }
+    });
 
-    cout << "\n Testing benefits:" << endl;
-    cout << "    No database connection needed" << endl;
-    cout << "    No email service needed" << endl;
-    cout << "    Fast test execution" << endl;
-    cout << "    Predictable test results" << endl;
+    char exact[32];
+    snprintf(exact, sizeof(exact), "%.6f", doubleTotal);
+    cout << "  " << itemCount << " x 0.10" << endl;
+    cout << "  sumMoney   : " << moneyMillis << " ms, total $" << total << endl;
+    cout << "  double sum : " << doubleMillis << " ms, total $" << exact << endl;
+    cout << "  min/maxMoney: " << minMaxMillis << " ms (min $" << lowest << ", max $" << highest << ")" << endl;
 }
 
-void demonstrateBenefits() {
-    printSubSeparator("🌟 BENEFITS SUMMARY");
+// Throughput OrderEngine dengan MockDatabase/MockNotification untuk 1..N worker thread
+void demonstrateOrderEngineScaling() {
+    printSubSeparator(" PERFORMANCE: OrderEngine Scaling");
 
-    cout << "Dependency Inversion Principle memberikan:" << endl << endl;
+    const int orderCount = 40000;
+    const int producerCount = 2;
+    unsigned int hardwareThreads = max(1u, thread::hardware_concurrency());
+    cout << "  " << orderCount << " orders, " << producerCount << " producers, "
+        << hardwareThreads << " hardware threads" << endl;
 
-    cout << " FLEXIBILITY:" << endl;
-    cout << "   - Mudah ganti implementation tanpa ubah client code" << endl;
-    cout << "   - Support multiple implementations simultaneously" << endl << endl;
+    auto sink = make_shared<NullSink>();
+    double baselineMillis = 0;
+    for (size_t threadCount = 1; threadCount <= max(4u, hardwareThreads); threadCount *= 2) {
+        OrderEngine engine(threadCount);
+        engine.addBackend("mock", make_shared<GoodRestaurantService>(
+            make_shared<MockDatabase>(sink), make_shared<MockNotification>(sink), sink), threadCount);
 
-    cout << " TESTABILITY:" << endl;
-    cout << "   - Easy mocking untuk unit testing" << endl;
-    cout << "   - Isolated testing tanpa external dependencies" << endl << endl;
+        atomic<int> completedCount{ 0 };
+        double millis = measureMillis([&] {
+            vector<thread> producers;
+            for (int p = 0; p < producerCount; ++p) {
+                producers.emplace_back([&, p] {
+                    for (int i = p; i < orderCount; i += producerCount) {
+                        engine.submit("mock", Order(i, "Mie Ayam", Money(15, 0)),
+                            [&](const Order&, bool) { completedCount.fetch_add(1, memory_order_relaxed); });
+                    }
+                });
+            }
+            for (auto& producer : producers) {
+                producer.join();
+            }
+            engine.shutdown();
+        });
+        if (threadCount == 1) {
+            baselineMillis = millis;
+        }
+        cout << "  " << threadCount << " thread(s): " << perSecond(orderCount, millis) << " orders/s, speedup x"
+            << baselineMillis / millis << " (" << completedCount.load() << " callbacks)" << endl;
+    }
+    if (hardwareThreads == 1) {
+        cout << "  (hanya 1 hardware thread: speedup tidak bisa diharapkan di mesin ini)" << endl;
+    }
+}
 
-    cout << " EXTENSIBILITY:" << endl;
-    cout << "   - Tambah fitur baru tanpa ubah existing code" << endl;
-    cout << "   - Open/Closed principle compliance" << endl << endl;
+// Path file sementara untuk demo yang menyentuh disk (unik per proses)
+string demoTempPath(const string& name) {
+    return "/tmp/order_demo_" + to_string(::getpid()) + "_" + name;
+}
 
-    cout << " MAINTAINABILITY:" << endl;
-    cout << "   - Perubahan terisolasi per module" << endl;
-    cout << "   - Reduced coupling = easier maintenance" << endl << endl;
+void removeDemoFiles(const string& path, initializer_list<const char*> suffixes = { "" }) {
+    for (const char* suffix : suffixes) {
+        ::unlink((path + suffix).c_str());
+    }
+}
 
-    cout << " TEAM PRODUCTIVITY:" << endl;
-    cout << "   - Parallel development dengan interfaces" << endl;
-    cout << "   - Clear separation of concerns" << endl << endl;
+void demonstrateLogStructuredStore() {
+    printSubSeparator(" PERFORMANCE: Log-Structured Store");
 
-    cout << " DIP Quote:" << endl;
-    cout << "\"True strength comes from flexibility." << endl;
-    cout << " Like bamboo that bends but never breaks.\" 🎋" << endl;
+    const int orderCount = 20000;
+    const int readCount = 20000;
+    vector<Order> orders = makeDemoOrders(orderCount);
+    string path = demoTempPath("orders.log");
+    removeDemoFiles(path, { "", ".ckpt" });
+    {
+        LogStructuredDatabase db(path);
+        double appendMillis = measureMillis([&] {
+            for (const auto& order : orders) {
+                db.save(order);
+            }
+        });
+        cout << "  save() append: " << perSecond(orderCount, appendMillis) << " orders/s" << endl;
+
+        double batchMillis = measureMillis([&] {
+            for (size_t start = 0; start < orders.size(); start += 256) {
+                db.saveBatch(OrderSpan(orders).subspan(start, 256));
+            }
+        });
+        cout << "  saveBatch(256) append: " << perSecond(orderCount, batchMillis) << " orders/s, dead bytes "
+            << db.getDeadBytes() << " / live " << db.getLiveBytes() << endl;
+
+        mt19937_64 random(7);
+        uniform_int_distribution<int> pick(1, orderCount);
+        for (const char* pattern : { "sequential", "random" }) {
+            bool sequential = string(pattern) == "sequential";
+            vector<double> latencies;
+            latencies.reserve(readCount);
+            for (int i = 0; i < readCount; ++i) {
+                int id = sequential ? 1 + i % orderCount : pick(random);
+                latencies.push_back(measureMillis([&] { db.findById(id); }) * 1000.0);
+            }
+            double totalMicros = accumulate(latencies.begin(), latencies.end(), 0.0);
+            cout << "  findById " << pattern << ": " << perSecond(readCount, totalMicros / 1000.0) << " reads/s, p50 "
+                << percentile(latencies, 50) << " us, p99 " << percentile(latencies, 99) << " us" << endl;
+        }
+    }
+
+    double recoveryMillis = measureMillis([&] { LogStructuredDatabase reopened(path); });
+    cout << "  recovery (full scan, " << 2 * orderCount << " records): " << recoveryMillis << " ms" << endl;
+    removeDemoFiles(path, { "", ".ckpt" });
+}
+
+void demonstrateDurabilityPolicies() {
+    printSubSeparator(" PERFORMANCE: WAL Durability Policies");
+
+    const int writerCount = 4;
+    const int ordersPerWriter = 100;
+    string walPath = demoTempPath("orders.wal");
+
+    for (auto policy : { DurabilityPolicy::None, DurabilityPolicy::Group, DurabilityPolicy::EveryWrite }) {
+        removeDemoFiles(walPath);
+        auto wal = make_shared<WriteAheadLog>(walPath, policy);
+        DurableDatabase db(make_shared<InMemoryDatabase>(), wal);
+
+        vector<vector<double>> latencies(writerCount);
+        double millis = measureMillis([&] {
+            vector<thread> writers;
+            for (int w = 0; w < writerCount; ++w) {
+                writers.emplace_back([&, w] {
+                    for (const auto& order : makeDemoOrders(ordersPerWriter, 1 + w * ordersPerWriter)) {
+                        latencies[w].push_back(measureMillis([&] { db.save(order); }));
+                    }
+                });
+            }
+            for (auto& writer : writers) {
+                writer.join();
+            }
+        });
+
+        vector<double> all;
+        for (const auto& samples : latencies) {
+            all.insert(all.end(), samples.begin(), samples.end());
+        }
+        const char* name = policy == DurabilityPolicy::None ? "None      "
+            : policy == DurabilityPolicy::Group ? "Group     " : "EveryWrite";
+        cout << "  " << name << ": " << perSecond(all.size(), millis) << " orders/s, commit p50 "
+            << percentile(all, 50) << " ms, p99 " << percentile(all, 99) << " ms, "
+            << wal->getStats().syncs << " fdatasync" << endl;
+    }
+
+    // Restart: WAL di-replay ke backend baru; checkpoint mengosongkan WAL
+    string logPath = demoTempPath("orders_wal_inner.log");
+    removeDemoFiles(logPath, { "", ".ckpt" });
+    auto store = make_shared<LogStructuredDatabase>(logPath);
+    DurableDatabase recovered(store, make_shared<WriteAheadLog>(walPath), [store] { store->sync(); });
+    cout << "  restart: " << store->size() << " orders replayed from WAL";
+    recovered.checkpoint();
+    cout << ", after checkpoint replay finds " << recovered.recover() << " records" << endl;
+    removeDemoFiles(walPath);
+    removeDemoFiles(logPath, { "", ".ckpt" });
+}
+
+void demonstrateSharding() {
+    printSubSeparator(" PERFORMANCE: Sharding");
+
+    const int orderCount = 4096;
+    const size_t batchSize = 512;
+    vector<Order> orders = makeDemoOrders(orderCount);
+    vector<int> ids;
+    for (const auto& order : orders) {
+        ids.push_back(order.getId());
+    }
+
+    cout << "  backend: 200 us round trip + 5 us per row" << endl;
+    for (size_t shardCount : { 1, 2, 4, 8 }) {
+        vector<shared_ptr<DatabaseService>> children;
+        for (size_t i = 0; i < shardCount; ++i) {
+            children.push_back(make_shared<SlowDatabase>(chrono::microseconds(200), chrono::microseconds(5)));
+        }
+        ShardedDatabase db(children);
+        double saveMillis = measureMillis([&] {
+            for (size_t start = 0; start < orders.size(); start += batchSize) {
+                db.saveBatch(OrderSpan(orders).subspan(start, batchSize));
+            }
+        });
+        vector<Order> found;
+        vector<int> missing;
+        double readMillis = measureMillis([&] {
+            for (size_t start = 0; start < ids.size(); start += batchSize) {
+                db.findByIds(IdSpan(ids).subspan(start, batchSize), found, missing);
+            }
+        });
+        cout << "  " << shardCount << " shard(s): saveBatch " << perSecond(orderCount, saveMillis)
+            << " orders/s, findByIds " << perSecond(found.size(), readMillis) << " orders/s" << endl;
+    }
+
+    // Routing hanya bergantung pada nama shard: urutan berbeda setelah restart, hasil sama
+    auto routeByName = [orderCount](const vector<string>& names) {
+        vector<pair<string, shared_ptr<DatabaseService>>> children;
+        map<DatabaseService*, string> nameOf;
+        for (const auto& name : names) {
+            children.emplace_back(name, make_shared<InMemoryDatabase>());
+            nameOf[children.back().second.get()] = name;
+        }
+        ShardedDatabase db(children);
+        vector<string> routes;
+        for (int id = 1; id <= orderCount; ++id) {
+            routes.push_back(nameOf[db.shardFor(id).get()]);
+        }
+        return routes;
+    };
+    vector<string> routes = routeByName({ "jakarta", "bandung", "surabaya", "medan" });
+    vector<string> restarted = routeByName({ "medan", "surabaya", "bandung", "jakarta" });
+    vector<string> removed = routeByName({ "jakarta", "bandung", "medan" });
+    size_t changedAfterRestart = 0, movedAfterRemove = 0, movedFromOthers = 0;
+    for (int i = 0; i < orderCount; ++i) {
+        changedAfterRestart += routes[i] != restarted[i];
+        movedAfterRemove += routes[i] != removed[i];
+        movedFromOthers += routes[i] != removed[i] && routes[i] != "surabaya";
+    }
+    cout << "  restart with shard order shuffled: " << changedAfterRestart << " of " << orderCount << " ids re-routed" << endl;
+    cout << "  remove \"surabaya\": " << movedAfterRemove << " ids moved ("
+        << movedFromOthers << " from other shards)" << endl;
+}
+
+void demonstrateReplication() {
+    printSubSeparator(" PERFORMANCE: Replication Quorum");
+
+    const int orderCount = 100;
+    vector<Order> orders = makeDemoOrders(orderCount);
+    cout << "  replicas: 200 us, 1 ms, 4 ms" << endl;
+
+    for (auto quorum : { WriteQuorum::One, WriteQuorum::Majority, WriteQuorum::All }) {
+        ReplicatedDatabase db({ make_shared<SlowDatabase>(chrono::microseconds(200)),
+            make_shared<SlowDatabase>(chrono::microseconds(1000)),
+            make_shared<SlowDatabase>(chrono::microseconds(4000)) }, quorum);
+
+        vector<double> latencies;
+        int staleReads = 0;
+        for (const auto& order : orders) {
+            latencies.push_back(measureMillis([&] { db.save(order); }));
+            try {
+                db.findById(order.getId()); // Read-your-writes: harus selalu ketemu
+            }
+            catch (const out_of_range&) {
+                staleReads++;
+            }
+        }
+        uint64_t maxLag = 0;
+        for (const auto& stats : db.getReplicaStats()) {
+            maxLag = max(maxLag, stats.lag);
+        }
+        const char* name = quorum == WriteQuorum::One ? "One     "
+            : quorum == WriteQuorum::Majority ? "Majority" : "All     ";
+        cout << "  " << name << ": save p50 " << percentile(latencies, 50) << " ms, p99 "
+            << percentile(latencies, 99) << " ms, slowest replica lag " << maxLag
+            << ", stale reads " << staleReads << endl;
+    }
+}
+
+// ns per lookup untuk setiap id di probeIds; checksum mencegah loop dibuang compiler
+template <typename Lookup>
+double nanosPerLookup(const vector<int>& probeIds, Lookup&& lookup) {
+    uint64_t checksum = 0;
+    double millis = measureMillis([&] {
+        for (int id : probeIds) {
+            checksum += lookup(id);
+        }
+    });
+    volatile uint64_t observed = checksum;
+    (void)observed;
+    return millis * 1e6 / probeIds.size();
+}
+
+// Index saja (id -> posisi slab) untuk OrderIndex vs std::map vs std::unordered_map,
+// plus findById penuh (shared lock + copy Order). 100M order tidak muat di demo;
+// ukuran dibatasi 1M, tren cache miss sudah terlihat.
+void demonstrateOrderIndex() {
+    printSubSeparator(" PERFORMANCE: In-Memory Order Index");
+
+    const size_t probeCount = 200000;
+    for (int orderCount : { 1000, 100000, 1000000 }) {
+        vector<int> ids(orderCount);
+        iota(ids.begin(), ids.end(), 1);
+        shuffle(ids.begin(), ids.end(), mt19937_64(orderCount));
+        vector<int> probeIds(probeCount);
+        for (size_t i = 0; i < probeCount; ++i) {
+            probeIds[i] = ids[(i * 7919) % ids.size()];
+        }
+
+        OrderIndex index;
+        map<int, uint32_t> ordered;
+        unordered_map<int, uint32_t> hashed;
+        for (size_t i = 0; i < ids.size(); ++i) {
+            index.insert(ids[i], static_cast<uint32_t>(i));
+            ordered.emplace(ids[i], static_cast<uint32_t>(i));
+            hashed.emplace(ids[i], static_cast<uint32_t>(i));
+        }
+        double indexNanos = nanosPerLookup(probeIds, [&](int id) { return *index.find(id); });
+        double mapNanos = nanosPerLookup(probeIds, [&](int id) { return ordered.find(id)->second; });
+        double hashNanos = nanosPerLookup(probeIds, [&](int id) { return hashed.find(id)->second; });
+
+        InMemoryDatabase db;
+        db.saveBatch(makeDemoOrders(orderCount));
+        double findNanos = nanosPerLookup(probeIds, [&](int id) { return db.findById(id).getId(); });
+
+        cout << "  " << orderCount << " orders: OrderIndex " << indexNanos << " ns, map " << mapNanos
+            << " ns, unordered_map " << hashNanos << " ns, InMemoryDatabase::findById " << findNanos << " ns" << endl;
+    }
+}
+
+// Kitchen display: 48 order sekaligus, findById berulang vs satu findByIds
+void demonstrateBatchLookup() {
+    printSubSeparator(" PERFORMANCE: Batch Lookup (findByIds)");
+
+    const int orderCount = 1000000;
+    const size_t screenSize = 48;
+    const int screens = 2000;
+    mt19937_64 random(16);
+    uniform_int_distribution<int> pick(1, orderCount + orderCount / 10); // ~9% id tidak ada
+    // Semua screen dalam satu vector; setiap screen adalah potongan IdSpan, tanpa copy
+    vector<int> allIds(screens * screenSize);
+    for (int& id : allIds) {
+        id = pick(random);
+    }
+    auto screenIds = [&](int screen) { return IdSpan(allIds).subspan(screen * screenSize, screenSize); };
+
+    InMemoryDatabase memory;
+    memory.saveBatch(makeDemoOrders(orderCount));
+    size_t foundCount = 0;
+    double loopMillis = measureMillis([&] {
+        for (int screen = 0; screen < screens; ++screen) {
+            for (int id : screenIds(screen)) {
+                try {
+                    memory.findById(id);
+                    foundCount++;
+                }
+                catch (const out_of_range&) {
+                }
+            }
+        }
+    });
+    vector<Order> found;
+    vector<int> missing;
+    double batchMillis = measureMillis([&] {
+        for (int screen = 0; screen < screens; ++screen) {
+            found.clear();
+            missing.clear();
+            memory.findByIds(screenIds(screen), found, missing);
+        }
+    });
+    cout << "  InMemory, " << orderCount << " orders: findById loop " << loopMillis * 1000 / screens
+        << " us/screen, findByIds " << batchMillis * 1000 / screens << " us/screen ("
+        << missing.size() << " missing on last screen, no exceptions)" << endl;
+
+    auto batchSink = make_shared<CountingSink>();
+    MySQLDatabase batchDb(batchSink);
+    found.clear();
+    missing.clear();
+    batchDb.findByIds(screenIds(0), found, missing);
+    cout << "  MySQL, one screen: " << batchSink->getLines() << " IN (...) statement(s) with findByIds" << endl;
+
+    auto slow = make_shared<SlowDatabase>(chrono::microseconds(500));
+    slow->saveBatch(makeDemoOrders(1000));
+    // Round trip dihitung oleh backend, bukan diturunkan dari ukuran screen
+    uint64_t tripsBefore = slow->getRoundTrips();
+    double slowLoop = measureMillis([&] {
+        for (int id = 1; id <= static_cast<int>(screenSize); ++id) {
+            slow->findById(id);
+        }
+    });
+    uint64_t loopTrips = slow->getRoundTrips() - tripsBefore;
+    vector<int> firstIds(screenSize);
+    iota(firstIds.begin(), firstIds.end(), 1);
+    found.clear();
+    missing.clear();
+    tripsBefore = slow->getRoundTrips();
+    double slowBatch = measureMillis([&] { slow->findByIds(firstIds, found, missing); });
+    uint64_t batchTrips = slow->getRoundTrips() - tripsBefore;
+    cout << "  500 us backend, one screen of " << screenSize << ": findById loop " << slowLoop << " ms in "
+        << loopTrips << " round trips, findByIds " << slowBatch << " ms in " << batchTrips << " round trip(s)" << endl;
+}
+
+// Startup: mmap snapshot vs deserialisasi penuh ke InMemoryDatabase.
+// Request menyebut 10M order; demo memakai 1M supaya tetap singkat.
+void demonstrateSnapshotStartup() {
+    printSubSeparator(" PERFORMANCE: Snapshot Startup");
+
+    const int orderCount = 1000000;
+    string path = demoTempPath("orders.snap");
+    double writeMillis = measureMillis([&] { OrderSnapshot::write(path, makeDemoOrders(orderCount)); });
+    cout << "  write " << orderCount << " orders: " << static_cast<long long>(writeMillis) << " ms" << endl;
+
+    double mapMillis = measureMillis([&] {
+        MappedSnapshotDatabase snapshot(path);
+        snapshot.findById(orderCount / 2);
+    });
+    double rebuildMillis = measureMillis([&] {
+        MappedSnapshotDatabase snapshot(path);
+        InMemoryDatabase rebuilt;
+        rebuilt.saveBatch(snapshot.allOrders());
+        rebuilt.findById(orderCount / 2);
+    });
+    cout << "  startup to first findById: mmap " << mapMillis << " ms, full rebuild " << rebuildMillis << " ms" << endl;
+
+    MappedSnapshotDatabase snapshot(path);
+    snapshot.save(Order(1, "Es Teh (diubah)", Money(5, 0)));
+    vector<int> probeIds(100000);
+    for (size_t i = 0; i < probeIds.size(); ++i) {
+        probeIds[i] = 2 + static_cast<int>((i * 7919) % (orderCount - 1));
+    }
+    auto find = [&](int id) { return snapshot.findById(id).getId(); };
+    double coldNanos = nanosPerLookup(probeIds, find); // Termasuk page fault pertama
+    double warmNanos = nanosPerLookup(probeIds, find);
+    double overlayNanos = nanosPerLookup(vector<int>(probeIds.size(), 1), find);
+    cout << "  findById: snapshot hit " << coldNanos << " ns cold / " << warmNanos << " ns warm, overlay hit "
+        << overlayNanos << " ns" << endl;
+
+    // Dua snapshot ditulis bersamaan ke path yang sama: file sementara tidak bentrok
+    auto first = OrderSnapshot::writeInBackground(path, makeDemoOrders(1000));
+    auto second = OrderSnapshot::writeInBackground(path, makeDemoOrders(2000));
+    first.get();
+    second.get();
+    cout << "  concurrent writeInBackground: snapshot has " << MappedSnapshotDatabase(path).getSnapshotSize()
+        << " orders (1000 or 2000, never torn)" << endl;
+    removeDemoFiles(path);
+}
+
+// Setengah lookup untuk id yang tidak ada (tablet stale, salah ketik)
+void demonstrateBloomFilter() {
+    printSubSeparator(" PERFORMANCE: Bloom Filter Negative Lookups");
+
+    const int orderCount = 10000;
+    const int lookupCount = 400;
+    vector<Order> orders = makeDemoOrders(orderCount);
+    vector<int> lookupIds;
+    for (int i = 0; i < lookupCount; ++i) {
+        lookupIds.push_back(i % 2 == 0 ? 1 + (i * 7) % orderCount : orderCount + 1 + i);
+    }
+    auto runLookups = [&](DatabaseService& db) {
+        return measureMillis([&] {
+            for (int id : lookupIds) {
+                try {
+                    db.findById(id);
+                }
+                catch (const out_of_range&) {
+                }
+            }
+        });
+    };
+
+    auto plainBackend = make_shared<SlowDatabase>(chrono::microseconds(1000));
+    plainBackend->saveBatch(orders);
+    double plainMillis = runLookups(*plainBackend);
+    cout << "  no filter: " << plainMillis << " ms, " << plainBackend->getRoundTrips() - 1 << " backend calls" << endl;
+
+    for (size_t maxBytes : { size_t(64 * 1024 * 1024), size_t(1024) }) {
+        auto backend = make_shared<SlowDatabase>(chrono::microseconds(1000));
+        BloomFilterDatabase filtered(backend, orderCount, 0.01, maxBytes);
+        filtered.saveBatch(orders);
+        double millis = runLookups(filtered);
+        BloomFilterStats stats = filtered.getStats();
+        cout << "  filter " << stats.bitCount / 8 << " bytes, " << stats.hashCount << " hashes: " << millis
+            << " ms, " << backend->getRoundTrips() - 1 << " backend calls, avoided " << stats.avoidedBackendCalls
+            << ", false positives " << stats.falsePositives << " of " << lookupCount / 2 << " misses" << endl;
+    }
+}
+
+// Compaction di background sementara reader dan writer tetap jalan
+void demonstrateCompaction() {
+    printSubSeparator(" PERFORMANCE: Online Compaction");
+
+    const int orderCount = 50000;
+    string path = demoTempPath("compact.log");
+    removeDemoFiles(path, { "", ".ckpt" });
+    LogStructuredDatabase db(path);
+    vector<Order> orders = makeDemoOrders(orderCount);
+    for (int round = 0; round < 4; ++round) {
+        db.saveBatch(orders); // 3 dari 4 versi jadi record mati
+    }
+
+    auto sampleReads = [&](atomic<bool>& running) {
+        vector<double> latencies;
+        mt19937_64 random(19);
+        uniform_int_distribution<int> pick(1, orderCount);
+        while (running.load()) {
+            int id = pick(random);
+            latencies.push_back(measureMillis([&] { db.findById(id); }) * 1000.0);
+            if (latencies.size() % 64 == 0) {
+                db.save(Order(id, "Update selama compaction", Money(1, 0)));
+            }
+        }
+        return latencies;
+    };
+
+    atomic<bool> running{ true };
+    auto idleReads = async(launch::async, [&] { return sampleReads(running); });
+    this_thread::sleep_for(chrono::milliseconds(100));
+    running = false;
+    vector<double> idle = idleReads.get();
+
+    running = true;
+    auto compactingReads = async(launch::async, [&] { return sampleReads(running); });
+    CompactionStats stats = db.compactInBackground().get();
+    running = false;
+    vector<double> compacting = compactingReads.get();
+
+    cout << "  compacted " << stats.bytesBefore / 1024 << " KB -> " << stats.bytesAfter / 1024 << " KB in "
+        << stats.duration.count() << " ms, logMutex held " << stats.lockHeld.count() << " us" << endl;
+    cout << "  read latency idle      : p50 " << percentile(idle, 50) << " us, p99 " << percentile(idle, 99)
+        << " us, max " << percentile(idle, 100) << " us" << endl;
+    cout << "  read latency compacting: p50 " << percentile(compacting, 50) << " us, p99 "
+        << percentile(compacting, 99) << " us, max " << percentile(compacting, 100) << " us" << endl;
+    removeDemoFiles(path, { "", ".ckpt", ".compact" });
+}
+
+// Burst 200 order ke kitchen yang butuh 1 ms per order, queue 32 slot
+void demonstrateAdmissionControl() {
+    printSubSeparator(" PERFORMANCE: Admission Control");
+
+    const int orderCount = 200;
+    vector<Order> orders = makeDemoOrders(orderCount);
+    for (auto policy : { AdmissionPolicy::Block, AdmissionPolicy::Reject, AdmissionPolicy::ShedLowestPriority }) {
+        AdmissionQueue queue([](const Order&) { this_thread::sleep_for(chrono::milliseconds(1)); },
+            32, policy, 2);
+        vector<double> submitLatencies;
+        double millis = measureMillis([&] {
+            for (int i = 0; i < orderCount; ++i) {
+                int priority = i % 10 == 0 ? 1 : 0; // 10% order VIP
+                submitLatencies.push_back(measureMillis([&] { queue.submit(orders[i], priority); }));
+            }
+            queue.shutdown();
+        });
+        AdmissionStats stats = queue.getStats();
+        const char* name = policy == AdmissionPolicy::Block ? "Block             "
+            : policy == AdmissionPolicy::Reject ? "Reject            " : "ShedLowestPriority";
+        cout << "  " << name << ": accepted " << stats.accepted << ", rejected " << stats.rejected
+            << ", shed " << stats.shed << ", submit p99 " << percentile(submitLatencies, 99)
+            << " ms, queue wait avg " << stats.averageQueueTime().count() / 1000.0 << " ms / max "
+            << stats.maxQueueTime.count() / 1000.0 << " ms, total " << static_cast<long long>(millis) << " ms" << endl;
+    }
+}
+
+// Provider ditagih per request: 400 pesan langsung vs digest per batch
+void demonstrateNotificationBatching() {
+    printSubSeparator(" PERFORMANCE: Notification Batching");
+
+    const int messageCount = 400;
+    const auto providerLatency = chrono::microseconds(500);
+    vector<string> messages;
+    for (int i = 1; i <= messageCount; ++i) {
+        messages.push_back("Order " + to_string(i) + " processed successfully!");
+    }
+
+    auto direct = make_shared<SlowNotification>(providerLatency);
+    double directMillis = measureMillis([&] {
+        for (const auto& message : messages) {
+            direct->send(message);
+        }
+    });
+    cout << "  direct: " << direct->getSent() << " provider requests, " << static_cast<long long>(directMillis) << " ms" << endl;
+
+    auto provider = make_shared<SlowNotification>(providerLatency);
+    BatchingNotification batching(provider, 32, 4096, chrono::milliseconds(20));
+    double batchMillis = measureMillis([&] {
+        for (int i = 0; i < messageCount; ++i) {
+            batching.send(messages[i]);
+            if (i % 100 == 99) {
+                this_thread::sleep_for(chrono::milliseconds(30)); // Jeda: sisa batch keluar lewat deadline
+            }
+        }
+        batching.shutdown();
+    });
+    BatchingStats stats = batching.getStats();
+    cout << "  batched: " << provider->getSent() << " provider requests, " << static_cast<long long>(batchMillis)
+        << " ms (incl. 120 ms pauses); flushes by count " << stats.flushesByCount << ", bytes "
+        << stats.flushesByBytes << ", deadline " << stats.flushesByDeadline << ", explicit " << stats.flushesByExplicit << endl;
+    cout << "  batch size histogram:";
+    for (size_t bucket = 0; bucket < stats.batchSizeHistogram.size(); ++bucket) {
+        if (stats.batchSizeHistogram[bucket] != 0) {
+            cout << " [" << (1u << bucket) << "+]=" << stats.batchSizeHistogram[bucket];
+        }
+    }
+    cout << endl;
+}
+
+void demonstrateCompositeNotification() {
+    printSubSeparator(" PERFORMANCE: Parallel Multi-Channel Notification");
+
+    const int messageCount = 50;
+    auto email = make_shared<SlowNotification>(chrono::microseconds(3000));
+    auto sms = make_shared<SlowNotification>(chrono::microseconds(2000));
+    auto slack = make_shared<SlowNotification>(chrono::microseconds(1000));
+
+    vector<double> sequential;
+    for (int i = 0; i < messageCount; ++i) {
+        sequential.push_back(measureMillis([&] {
+            email->send("VIP order");
+            sms->send("VIP order");
+            slack->send("VIP order");
+        }));
+    }
+
+    CompositeNotification composite({ email, sms, slack }, chrono::milliseconds(500));
+    vector<double> parallel;
+    for (int i = 0; i < messageCount; ++i) {
+        parallel.push_back(measureMillis([&] { composite.send("VIP order"); }));
+    }
+    composite.shutdown();
+    cout << "  channels 3 ms + 2 ms + 1 ms: sequential p50 " << percentile(sequential, 50)
+        << " ms, composite p50 " << percentile(parallel, 50) << " ms, p99 " << percentile(parallel, 99) << " ms" << endl;
+
+    // Channel macet dibatasi timeout; channel lain tetap terkirim
+    auto stuck = make_shared<SlowNotification>(chrono::microseconds(200000));
+    auto healthy = make_shared<SlowNotification>(chrono::microseconds(1000));
+    CompositeNotification bounded({ NotificationChannel{ stuck, chrono::milliseconds(20) },
+        NotificationChannel{ healthy, chrono::milliseconds(20) } });
+    double boundedMillis = measureMillis([&] { bounded.send("VIP order"); });
+    cout << "  stuck 200 ms channel with 20 ms timeout: send() took " << boundedMillis << " ms, healthy channel sent "
+        << healthy->getSent() << endl;
+}
+
+void demonstrateRateLimiting() {
+    printSubSeparator(" PERFORMANCE: SMS Rate Limiting");
+
+    const int messageCount = 1000000;
+    auto sink = make_shared<NullSink>();
+    auto unlimited = make_shared<MockNotification>(sink);
+    double baseNanos = measureMillis([&] {
+        for (int i = 0; i < messageCount; ++i) {
+            unlimited->send("Order processed");
+        }
+    }) * 1e6 / messageCount;
+    RateLimitedNotification underQuota(make_shared<MockNotification>(sink), 1e9, 1000);
+    double limitedNanos = measureMillis([&] {
+        for (int i = 0; i < messageCount; ++i) {
+            underQuota.send("Order processed");
+        }
+    }) * 1e6 / messageCount;
+    cout << "  under quota: " << baseNanos << " ns/send without limiter, " << limitedNanos << " ns/send with limiter" << endl;
+
+    // Rush: 60 pesan sekaligus ke gateway 50/s dengan burst 10
+    for (auto policy : { RateLimitPolicy::Drop, RateLimitPolicy::Wait }) {
+        auto gateway = make_shared<SlowNotification>(chrono::microseconds(0));
+        RateLimitedNotification limited(gateway, 50, 10, policy, chrono::milliseconds(2000));
+        double millis = measureMillis([&] {
+            for (int i = 0; i < 60; ++i) {
+                limited.send("Order processed");
+            }
+        });
+        RateLimitStats stats = limited.getStats();
+        cout << "  rush of 60 at 50/s, burst 10, " << (policy == RateLimitPolicy::Drop ? "Drop" : "Wait") << ": sent "
+            << gateway->getSent() << ", throttled " << stats.throttled << ", dropped " << stats.dropped
+            << ", " << static_cast<long long>(millis) << " ms" << endl;
+    }
+}
+
+// Provider down selama burst: send() tetap mikrodetik, kegagalan masuk dead-letter file
+void demonstrateRetryAndDeadLetters() {
+    printSubSeparator(" PERFORMANCE: Retry + Dead-Letter Queue");
+
+    const int messageCount = 500;
+    string path = demoTempPath("notifications.dlq");
+    removeDemoFiles(path, { "", ".tmp" });
+    auto deadLetters = make_shared<DeadLetterQueue>(path);
+    auto provider = make_shared<OutageNotification>();
+
+    RetryPolicy policy;
+    policy.maxAttempts = 3;
+    policy.baseDelay = chrono::milliseconds(1);
+    policy.maxDelay = chrono::milliseconds(4);
+    RetryingNotification retrying(provider, deadLetters, policy, 256);
+    vector<double> sendMicros;
+    for (int i = 1; i <= messageCount; ++i) {
+        string message = "Order " + to_string(i) + " processed successfully!";
+        sendMicros.push_back(measureMillis([&] { retrying.send(message); }) * 1000.0);
+    }
+    this_thread::sleep_for(chrono::milliseconds(30)); // Beri waktu untuk backoff + retry
+    retrying.shutdown();
+    RetryStats stats = retrying.getStats();
+    cout << "  send() during outage: p50 " << percentile(sendMicros, 50) << " us, p99 " << percentile(sendMicros, 99)
+        << " us, max " << percentile(sendMicros, 100) << " us" << endl;
+    cout << "  enqueued " << stats.enqueued << ", overflowed " << stats.overflowed << ", attempts " << stats.attempts
+        << ", dead-lettered " << stats.deadLettered << ", lost " << stats.lost << endl;
+
+    // Replay ke provider yang lambat; append baru tidak menunggu replay selesai
+    auto slowProvider = make_shared<SlowNotification>(chrono::microseconds(200));
+    atomic<bool> replaying{ true };
+    vector<double> appendMillis;
+    thread appender([&] {
+        for (int i = 0; i < 20 && replaying.load(); ++i) {
+            appendMillis.push_back(measureMillis([&] { deadLetters->append("Late order", 1, "provider unavailable"); }));
+        }
+    });
+    ReplayResult replayed;
+    double replayMillis = measureMillis([&] { replayed = deadLetters->replay(*slowProvider); });
+    replaying = false;
+    appender.join();
+    cout << "  replay: " << replayed.delivered << " delivered in " << static_cast<long long>(replayMillis)
+        << " ms; " << appendMillis.size() << " concurrent appends, max " << percentile(appendMillis, 100)
+        << " ms; " << deadLetters->size() << " letters left" << endl;
+    removeDemoFiles(path, { "", ".tmp" });
+}
+
+// Dependency tanpa efek samping: yang terukur hanya alokasi milik processOrder sendiri
+struct DiscardingStore {
+    void save(const Order&) {}
+    Order findById(int id) { return Order(id, "", Money()); }
+    string getType() const { return "Discarding Store"; }
+};
+
+struct DiscardingNotifier {
+    size_t bytes = 0;
+    void send(string_view message) { bytes += message.size(); }
+    string getType() const { return "Discarding Notifier"; }
+};
+
+void demonstrateMessageTemplates() {
+    printSubSeparator(" PERFORMANCE: Allocation-free Messages");
+
+    const int messageCount = 100000;
+    size_t bytes = 0;
+    uint64_t concatAllocations = 0;
+    double concatMillis = measureMillis([&] {
+        concatAllocations = countAllocations([&] {
+            for (int id = 1000000; id < 1000000 + messageCount; ++id) {
+                string message = "Order " + to_string(id) + " processed successfully!";
+                bytes += message.size();
+            }
+        });
+    });
+    uint64_t templateAllocations = 0;
+    double templateMillis = measureMillis([&] {
+        templateAllocations = countAllocations([&] {
+            for (int id = 1000000; id < 1000000 + messageCount; ++id) {
+                bytes += renderMessage("Order ", id, " processed successfully!").view().size();
+            }
+        });
+    });
+    cout << "  " << messageCount << " messages: string concat " << concatAllocations << " allocations, "
+        << static_cast<long long>(concatMillis * 1e6 / messageCount) << " ns/msg; renderMessage "
+        << templateAllocations << " allocations, " << static_cast<long long>(templateMillis * 1e6 / messageCount)
+        << " ns/msg" << endl;
+
+    BasicRestaurantService<DiscardingStore, DiscardingNotifier> service{ DiscardingStore{}, DiscardingNotifier{},
+        make_shared<NullSink>() };
+    Order order(42, "Es Teh", Money(5, 0));
+    service.processOrder(order); // Warm-up
+    uint64_t processAllocations = countAllocations([&] {
+        for (int i = 0; i < messageCount; ++i) {
+            service.processOrder(order);
+        }
+    });
+    expectNoAllocations(to_string(messageCount) + " x renderMessage", templateAllocations);
+    expectNoAllocations(to_string(messageCount) + " x processOrder", processAllocations);
+
+    // Buffer char (bukan literal) dirender sampai '\0' pertama, bukan N - 1 byte
+    char table[16] = "Meja 5";
+    auto rendered = renderMessage("Pesanan ", table);
+    cout << "  char[16] field: \"" << rendered.view() << "\" (" << rendered.view().size() << " of "
+        << rendered.capacity() << " bytes)" << endl;
+
+    volatile size_t observed = bytes;
+    (void)observed;
+}
+
+// Output lama: satu flush (endl) per baris, semua thread rebutan satu stream
+void demonstrateBufferedOutput() {
+    printSubSeparator(" PERFORMANCE: Buffered Output Sink");
+
+    const int threadCount = 4;
+    const int linesPerThread = 20000;
+    const string line = " MySQL: Saving to MySQL database: Order{id=42, amount=$35.00}";
+
+    auto runWriters = [&](const function<void()>& writeLines) {
+        vector<thread> writers;
+        for (int i = 0; i < threadCount; ++i) {
+            writers.emplace_back(writeLines);
+        }
+        for (auto& writer : writers) {
+            writer.join();
+        }
+    };
+
+    FILE* target = tmpfile();
+    if (target == nullptr) {
+        cout << "  tmpfile() not available, skipped" << endl;
+        return;
+    }
+
+    mutex streamMutex;
+    double flushPerLineMillis = measureMillis([&] {
+        runWriters([&] {
+            for (int i = 0; i < linesPerThread; ++i) {
+                lock_guard<mutex> lock(streamMutex);
+                fwrite(line.data(), 1, line.size(), target);
+                fputc('\n', target);
+                fflush(target);
+            }
+        });
+    });
+
+    double bufferedMillis = measureMillis([&] {
+        BufferedSink sink(FlushPolicy::SizeThreshold, 64 * 1024, chrono::milliseconds(100), target);
+        runWriters([&] {
+            for (int i = 0; i < linesPerThread; ++i) {
+                sink.writeLine(line);
+            }
+        });
+        sink.flush();
+    });
+    fclose(target);
+
+    size_t totalLines = static_cast<size_t>(threadCount) * linesPerThread;
+    cout << "  flush per line      : " << perSecond(totalLines, flushPerLineMillis) << " lines/s" << endl;
+    cout << "  BufferedSink (64 KB): " << perSecond(totalLines, bufferedMillis) << " lines/s" << endl;
 }
 
 // ==================== MAIN FUNCTION ====================
@@ -488,6 +5857,7 @@ int main() {
     cout << "4.  Solution 3: Strategy Pattern" << endl;
     cout << "5.  Testing Benefits" << endl;
     cout << "6.  Summary of Benefits" << endl;
+    cout << "7.  Performance Demos" << endl;
 
     // 1. Demonstrate the problem
     demonstrateProblem();
@@ -507,6 +5877,39 @@ int main() {
     // 6. Benefits summary
     demonstrateBenefits();
 
+    // 7. Performance demos
+    printSeparator(" PERFORMANCE DEMOS");
+    demonstrateBatchSave();
+    demonstrateBufferedOutput();
+    demonstrateAsyncNotification();
+    demonstrateReadThroughCache();
+    demonstrateCompileTimeDispatch();
+    demonstrateColumnarStore();
+    demonstrateAllocationFreePayment();
+    demonstrateOrderFormatting();
+    demonstrateMoneyAggregation();
+    demonstrateOrderEngineScaling();
+    demonstrateLogStructuredStore();
+    demonstrateDurabilityPolicies();
+    demonstrateSharding();
+    demonstrateReplication();
+    demonstrateOrderIndex();
+    demonstrateBatchLookup();
+    demonstrateSnapshotStartup();
+    demonstrateBloomFilter();
+    demonstrateCompaction();
+    demonstrateAdmissionControl();
+    demonstrateNotificationBatching();
+    demonstrateCompositeNotification();
+    demonstrateRateLimiting();
+    demonstrateRetryAndDeadLetters();
+    demonstrateMessageTemplates();
+
+    if (failedDemoChecks > 0) {
+        cerr << "\n" << failedDemoChecks << " demo check(s) FAILED" << endl;
+        return 1;
+    }
+
     printSeparator(" DEMO COMPLETED!");
     cout << "Key Takeaway: DIP = Depend on abstractions, not concretions!" << endl;
     cout << "High-level modules should not depend on low-level modules." << endl;
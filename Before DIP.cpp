@@ -2,42 +2,686 @@
 #include <string>
 #include <memory>
 #include <map>
+#include <vector>
+#include <unordered_map>
+#include <string_view>
+#include <optional>
+#include <charconv>
+#include <algorithm>
 #include <stdexcept>
+#include <cstdio>
+#include <cstdint>
+#include <chrono>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <limits>
+#include <type_traits>
 
 using namespace std;
 
 // ==================== SUPPORTING CLASSES ====================
 
+// Output abstraction - service menulis lewat sink, bukan langsung ke cout + endl
+class OutputSink {
+public:
+    virtual ~OutputSink() = default;
+    virtual void writeLine(string_view line) = 0;
+    virtual void endOrder() {} // Dipanggil setelah satu order selesai diproses
+    virtual void flush() {}
+};
+
+// Default sink: tulis ke ostream dengan '\n' (tanpa flush per baris)
+class StreamSink : public OutputSink {
+private:
+    ostream& out;
+    mutex writeMutex;
+
+public:
+    explicit StreamSink(ostream& os) : out(os) {}
+
+    void writeLine(string_view line) override {
+        lock_guard<mutex> lock(writeMutex);
+        out << line << '\n';
+    }
+
+    void flush() override {
+        lock_guard<mutex> lock(writeMutex);
+        out.flush();
+    }
+};
+
+enum class FlushPolicy {
+    PerOrder,      // Flush di setiap endOrder()
+    SizeThreshold, // Flush saat buffer melewati sizeThreshold bytes
+    Timed          // Flush oleh timer thread setiap flushInterval
+};
+
+// Buffered sink: per-thread buffer, uncontended mutex. Setiap thread punya buffer
+// sendiri dengan mutex-nya sendiri; writeLine() tetap mengunci mutex itu, tapi yang
+// bisa ikut mengunci hanya flush()/timer dari thread lain, jadi writer antar thread
+// tidak saling menunggu. Satu fwrite + fflush per flush, bukan satu flush per baris. Semua buffer
+// terdaftar di sink, jadi flush() dan timer bisa mengosongkan buffer semua thread.
+class BufferedSink : public OutputSink {
+private:
+    struct ThreadBuffer {
+        mutex bufferMutex;
+        FILE* target = nullptr; // nullptr setelah sink di-destroy
+        string data;
+        chrono::steady_clock::time_point lastFlush = chrono::steady_clock::now();
+
+        // Dipanggil dengan bufferMutex terkunci
+        void flushLocked() {
+            if (!data.empty() && target != nullptr) {
+                fwrite(data.data(), 1, data.size(), target);
+                fflush(target);
+            }
+            data.clear();
+            lastFlush = chrono::steady_clock::now();
+        }
+    };
+
+    // Buffer milik satu thread untuk semua BufferedSink; sisa output di-flush saat thread selesai
+    struct ThreadBuffers {
+        map<uint64_t, shared_ptr<ThreadBuffer>> bySink;
+
+        ~ThreadBuffers() {
+            for (auto& entry : bySink) {
+                lock_guard<mutex> lock(entry.second->bufferMutex);
+                entry.second->flushLocked();
+            }
+        }
+
+        // Hapus buffer milik sink yang sudah di-destroy
+        void pruneDetached() {
+            for (auto entry = bySink.begin(); entry != bySink.end();) {
+                bool detached;
+                {
+                    lock_guard<mutex> lock(entry->second->bufferMutex);
+                    detached = entry->second->target == nullptr;
+                }
+                entry = detached ? bySink.erase(entry) : next(entry);
+            }
+        }
+    };
+
+    FILE* target;
+    FlushPolicy policy;
+    size_t sizeThreshold;
+    chrono::milliseconds flushInterval;
+    uint64_t sinkId;
+
+    mutex registryMutex;
+    vector<shared_ptr<ThreadBuffer>> registry; // Buffer semua thread yang pernah menulis
+
+    mutex timerMutex;
+    condition_variable timerWakeup;
+    bool stopping = false;
+    thread timer;
+
+    static uint64_t nextSinkId() {
+        static atomic<uint64_t> counter{ 0 };
+        return ++counter;
+    }
+
+    static ThreadBuffers& threadBuffers() {
+        thread_local ThreadBuffers buffers;
+        return buffers;
+    }
+
+    ThreadBuffer& localBuffer() {
+        ThreadBuffers& buffers = threadBuffers();
+        auto entry = buffers.bySink.find(sinkId);
+        if (entry != buffers.bySink.end()) {
+            return *entry->second;
+        }
+
+        // Slow path: pertama kali thread ini menulis ke sink ini
+        buffers.pruneDetached();
+        auto buffer = make_shared<ThreadBuffer>();
+        buffer->target = target;
+        {
+            lock_guard<mutex> lock(registryMutex);
+            registry.push_back(buffer);
+        }
+        return *buffers.bySink.emplace(sinkId, buffer).first->second;
+    }
+
+    // Dipanggil dengan bufferMutex terkunci
+    void flushIfDue(ThreadBuffer& buffer) {
+        if (policy == FlushPolicy::SizeThreshold && buffer.data.size() >= sizeThreshold) {
+            buffer.flushLocked();
+        }
+        else if (policy == FlushPolicy::Timed &&
+            chrono::steady_clock::now() - buffer.lastFlush >= flushInterval) {
+            buffer.flushLocked();
+        }
+    }
+
+    void flushAll() {
+        vector<shared_ptr<ThreadBuffer>> buffers;
+        {
+            lock_guard<mutex> lock(registryMutex);
+            // Buffer yang hanya dipegang registry milik thread yang sudah selesai
+            registry.erase(remove_if(registry.begin(), registry.end(),
+                [](const shared_ptr<ThreadBuffer>& buffer) { return buffer.use_count() == 1; }),
+                registry.end());
+            buffers = registry;
+        }
+        for (auto& buffer : buffers) {
+            lock_guard<mutex> lock(buffer->bufferMutex);
+            buffer->flushLocked();
+        }
+    }
+
+    void timerLoop() {
+        unique_lock<mutex> lock(timerMutex);
+        while (!timerWakeup.wait_for(lock, flushInterval, [this] { return stopping; })) {
+            lock.unlock();
+            flushAll();
+            lock.lock();
+        }
+    }
+
+public:
+    BufferedSink(FlushPolicy policy = FlushPolicy::PerOrder,
+        size_t sizeThreshold = 64 * 1024,
+        chrono::milliseconds flushInterval = chrono::milliseconds(100),
+        FILE* target = stdout)
+        : target(target), policy(policy), sizeThreshold(sizeThreshold),
+        flushInterval(flushInterval), sinkId(nextSinkId()) {
+        if (policy == FlushPolicy::Timed) {
+            timer = thread(&BufferedSink::timerLoop, this);
+        }
+    }
+
+    // Flush semua buffer lalu lepaskan dari thread-nya (target jadi nullptr);
+    // entry thread_local dihapus saat thread itu mendaftar ke sink lain atau selesai
+    ~BufferedSink() override {
+        if (timer.joinable()) {
+            {
+                lock_guard<mutex> lock(timerMutex);
+                stopping = true;
+            }
+            timerWakeup.notify_one();
+            timer.join();
+        }
+
+        lock_guard<mutex> registryLock(registryMutex);
+        for (auto& buffer : registry) {
+            lock_guard<mutex> lock(buffer->bufferMutex);
+            buffer->flushLocked();
+            buffer->target = nullptr;
+            buffer->data.shrink_to_fit();
+        }
+    }
+
+    BufferedSink(const BufferedSink&) = delete;
+    BufferedSink& operator=(const BufferedSink&) = delete;
+
+    void writeLine(string_view line) override {
+        ThreadBuffer& buffer = localBuffer();
+        lock_guard<mutex> lock(buffer.bufferMutex); // Uncontended kecuali flush() sedang jalan
+        buffer.data += line;
+        buffer.data += '\n';
+        flushIfDue(buffer);
+    }
+
+    void endOrder() override {
+        ThreadBuffer& buffer = localBuffer();
+        lock_guard<mutex> lock(buffer.bufferMutex);
+        if (policy == FlushPolicy::PerOrder) {
+            buffer.flushLocked();
+        }
+        else {
+            flushIfDue(buffer);
+        }
+    }
+
+    // Flush buffer semua thread, bukan hanya thread pemanggil
+    void flush() override {
+        flushAll();
+    }
+};
+
+// Null sink: buang semua output (untuk benchmark logic murni)
+class NullSink : public OutputSink {
+public:
+    void writeLine(string_view) override {}
+};
+
+shared_ptr<OutputSink> defaultOutputSink() {
+    static shared_ptr<OutputSink> sink = make_shared<StreamSink>(cout);
+    return sink;
+}
+
+// ==================== FORMATTING HELPERS ====================
+// Semua helper menulis ke buffer milik caller dan return pointer setelah
+// karakter terakhir, atau nullptr kalau buffer tidak cukup (gaya to_chars).
+
+char* appendText(char* first, char* last, string_view text) {
+    if (first == nullptr || static_cast<size_t>(last - first) < text.size()) {
+        return nullptr;
+    }
+    return copy(text.begin(), text.end(), first);
+}
+
+char* appendInteger(char* first, char* last, long long value) {
+    if (first == nullptr) {
+        return nullptr;
+    }
+    auto result = to_chars(first, last, value);
+    return result.ec == errc() ? result.ptr : nullptr;
+}
+
+// Money selalu dua desimal: 3500 cents -> "35.00"
+char* appendCents(char* first, char* last, long long cents) {
+    // Magnitude sebagai unsigned: -LLONG_MIN tidak muat di long long
+    unsigned long long magnitude = static_cast<unsigned long long>(cents);
+    if (cents < 0) {
+        first = appendText(first, last, "-");
+        magnitude = 0ULL - magnitude;
+    }
+    if (first == nullptr) {
+        return nullptr;
+    }
+    auto units = to_chars(first, last, magnitude / 100);
+    first = units.ec == errc() ? units.ptr : nullptr;
+    first = appendText(first, last, ".");
+    if (first == nullptr || last - first < 2) {
+        return nullptr;
+    }
+    *first++ = static_cast<char>('0' + (magnitude % 100) / 10);
+    *first++ = static_cast<char>('0' + magnitude % 10);
+    return first;
+}
+
+// ==================== MONEY ====================
+// Fixed-point money: int64 dalam cents. Penjumlahan exact (tidak seperti double)
+// dan bisa di-vectorize sebagai integer SIMD.
+
+class Money {
+private:
+    int64_t cents;
+
+    struct CentsTag {};
+    constexpr Money(CentsTag, int64_t value) : cents(value) {}
+
+    // Validasi sebelum mengalikan: units * 100 +/- fraction tidak boleh overflow int64
+    static constexpr int64_t checkedCents(int64_t units, int64_t fraction) {
+        if (fraction < 0 || fraction >= CENTS_PER_UNIT) {
+            throw invalid_argument("Money fraction must be in [0, 100): " + to_string(fraction));
+        }
+        // Pembagian C++ membulatkan ke nol: untuk batas positif itu floor, untuk negatif ceil
+        if (units > (numeric_limits<int64_t>::max() - fraction) / CENTS_PER_UNIT ||
+            units < (numeric_limits<int64_t>::min() + fraction) / CENTS_PER_UNIT) {
+            throw overflow_error("Money units out of range: " + to_string(units));
+        }
+        return units < 0 ? units * CENTS_PER_UNIT - fraction : units * CENTS_PER_UNIT + fraction;
+    }
+
+public:
+    static constexpr int64_t CENTS_PER_UNIT = 100;
+
+    constexpr Money() : cents(0) {}
+
+    // Money(35, 50) == $35.50, Money(-3, 50) == -$3.50 (tanda units berlaku untuk fraction).
+    // fraction harus 0..99; untuk -$0.50 pakai fromCents(-50).
+    constexpr Money(int64_t units, int64_t fraction)
+        : cents(checkedCents(units, fraction)) {
+    }
+
+    static constexpr Money fromCents(int64_t cents) {
+        return Money(CentsTag{}, cents);
+    }
+
+    constexpr int64_t getCents() const { return cents; }
+    double toDouble() const { return static_cast<double>(cents) / CENTS_PER_UNIT; }
+
+    constexpr Money operator+(Money other) const { return fromCents(cents + other.cents); }
+    constexpr Money operator-(Money other) const { return fromCents(cents - other.cents); }
+    Money& operator+=(Money other) { cents += other.cents; return *this; }
+    Money& operator-=(Money other) { cents -= other.cents; return *this; }
+
+    constexpr bool operator==(Money other) const { return cents == other.cents; }
+    constexpr bool operator!=(Money other) const { return cents != other.cents; }
+    constexpr bool operator<(Money other) const { return cents < other.cents; }
+    constexpr bool operator>(Money other) const { return cents > other.cents; }
+    constexpr bool operator<=(Money other) const { return cents <= other.cents; }
+    constexpr bool operator>=(Money other) const { return cents >= other.cents; }
+
+    char* formatTo(char* first, char* last) const {
+        return appendCents(first, last, cents);
+    }
+
+    string toString() const {
+        char buffer[32];
+        return string(buffer, formatTo(buffer, buffer + sizeof(buffer)));
+    }
+};
+
+ostream& operator<<(ostream& out, Money amount) {
+    return out << amount.toString();
+}
+
+// Aggregation kernels untuk reporting. Loop integer sederhana tanpa dependency
+// antar-iterasi, jadi compiler bisa auto-vectorize (SSE/AVX) di -O2/-O3.
+Money sumMoney(const Money* values, size_t count) {
+    int64_t total = 0;
+    for (size_t i = 0; i < count; ++i) {
+        total += values[i].getCents();
+    }
+    return Money::fromCents(total);
+}
+
+Money minMoney(const Money* values, size_t count) {
+    if (count == 0) {
+        return Money();
+    }
+    int64_t lowest = values[0].getCents();
+    for (size_t i = 1; i < count; ++i) {
+        lowest = min(lowest, values[i].getCents());
+    }
+    return Money::fromCents(lowest);
+}
+
+Money maxMoney(const Money* values, size_t count) {
+    if (count == 0) {
+        return Money();
+    }
+    int64_t highest = values[0].getCents();
+    for (size_t i = 1; i < count; ++i) {
+        highest = max(highest, values[i].getCents());
+    }
+    return Money::fromCents(highest);
+}
+
 class Order {
 private:
     int id;
     string description;
-    double totalAmount;
+    Money totalAmount;
     string paymentType;
     string paymentInfo;
 
 public:
-    Order(int id, const string& desc, double amount)
-        : id(id), description(desc), totalAmount(amount) {
+    // String diambil by value lalu di-move: caller dengan rvalue tidak perlu copy
+    Order(int id, string desc, Money amount)
+        : id(id), description(move(desc)), totalAmount(amount) {
     }
 
-    // Getters
+    // Getters - string_view, tanpa copy/alokasi
     int getId() const { return id; }
-    string getDescription() const { return description; }
-    double getTotalAmount() const { return totalAmount; }
-    string getPaymentType() const { return paymentType; }
-    string getPaymentInfo() const { return paymentInfo; }
+    string_view getDescription() const { return description; }
+    Money getTotalAmount() const { return totalAmount; }
+    string_view getPaymentType() const { return paymentType; }
+    string_view getPaymentInfo() const { return paymentInfo; }
 
     // Setters for payment
-    void setPaymentInfo(const string& type, const string& info) {
-        paymentType = type;
-        paymentInfo = info;
+    void setPaymentInfo(string type, string info) {
+        paymentType = move(type);
+        paymentInfo = move(info);
+    }
+
+    // Tulis "Order{id=.., description='..', amount=$35.00}" ke buffer caller
+    char* formatTo(char* first, char* last) const {
+        first = appendText(first, last, "Order{id=");
+        first = appendInteger(first, last, id);
+        first = appendText(first, last, ", description='");
+        first = appendText(first, last, description);
+        first = appendText(first, last, "', amount=$");
+        first = totalAmount.formatTo(first, last);
+        return appendText(first, last, "}");
+    }
+
+    // Batas atas panjang hasil formatTo()
+    size_t formattedSizeLimit() const {
+        return description.size() + 80;
     }
 
     string toString() const {
-        return "Order{id=" + to_string(id) +
-            ", description='" + description +
-            "', amount=$" + to_string(totalAmount) + "}";
+        string result(formattedSizeLimit(), '\0');
+        result.resize(formatTo(result.data(), result.data() + result.size()) - result.data());
+        return result;
+    }
+};
+
+// Format satu batch ke satu buffer contiguous, satu order per baris
+void formatOrders(const vector<Order>& orders, string& out) {
+    size_t limit = 0;
+    for (const auto& order : orders) {
+        limit += order.formattedSizeLimit() + 1;
+    }
+
+    size_t start = out.size();
+    out.resize(start + limit);
+    char* cursor = out.data() + start;
+    char* last = out.data() + out.size();
+    for (const auto& order : orders) {
+        cursor = order.formatTo(cursor, last);
+        *cursor++ = '\n';
+    }
+    out.resize(cursor - out.data());
+}
+
+// Tulis "<prefix><order>" lewat stack buffer, tanpa string sementara
+void writeOrderLine(OutputSink& sink, string_view prefix, const Order& order) {
+    char buffer[256];
+    char* end = appendText(buffer, buffer + sizeof(buffer), prefix);
+    end = order.formatTo(end, buffer + sizeof(buffer));
+    if (end != nullptr) {
+        sink.writeLine(string_view(buffer, end - buffer));
+    }
+    else {
+        sink.writeLine(string(prefix) + order.toString()); // Description panjang
+    }
+}
+
+// Tulis "<prefix><amount>" lewat stack buffer
+void writeAmountLine(OutputSink& sink, string_view prefix, Money amount) {
+    char buffer[128];
+    char* end = appendText(buffer, buffer + sizeof(buffer), prefix);
+    end = amount.formatTo(end, buffer + sizeof(buffer));
+    if (end != nullptr) {
+        sink.writeLine(string_view(buffer, end - buffer));
+    }
+    else {
+        sink.writeLine(string(prefix) + amount.toString());
+    }
+}
+
+// ==================== MESSAGE TEMPLATES ====================
+// renderMessage("Order ", id, " processed!") menulis ke MessageBuffer di stack.
+// Kapasitas dihitung saat compile dari tipe setiap bagian (literal char[N],
+// integer, Money), jadi render tidak pernah alokasi heap dan tidak bisa overflow.
+
+template <size_t Capacity>
+class MessageBuffer {
+private:
+    char data[Capacity > 0 ? Capacity : 1];
+    size_t length = 0;
+
+public:
+    static constexpr size_t capacity() { return Capacity; }
+
+    char* begin() { return data; }
+    char* end() { return data + Capacity; }
+    void setLength(size_t newLength) { length = newLength; }
+
+    string_view view() const { return string_view(data, length); }
+    operator string_view() const { return view(); }
+};
+
+// Field type yang tidak didukung (mis. string) sengaja tidak punya specialization:
+// compile error, bukan buffer yang diam-diam terpotong
+template <typename T, typename = void>
+struct MessageField;
+
+// Array char juga bisa buffer (bukan literal): berhenti di '\0' pertama, maksimal N - 1
+template <size_t N>
+struct MessageField<char[N]> {
+    static constexpr size_t capacity = N - 1;
+    static char* append(char* first, char* last, const char (&text)[N]) {
+        const char* terminator = char_traits<char>::find(text, N - 1, '\0');
+        return appendText(first, last, string_view(text, terminator ? terminator - text : N - 1));
+    }
+};
+
+// char/wchar_t/char16_t/char32_t bukan angka: 'A' tidak boleh jadi "65".
+// signed/unsigned char (int8_t/uint8_t) tetap dirender sebagai angka.
+template <typename T>
+constexpr bool isCharacterType = is_same_v<T, char> || is_same_v<T, wchar_t> ||
+    is_same_v<T, char16_t> || is_same_v<T, char32_t>;
+
+template <typename T>
+struct MessageField<T, enable_if_t<is_integral_v<T> && !is_same_v<T, bool> && !isCharacterType<T>>> {
+    static constexpr size_t capacity = numeric_limits<T>::digits10 + 2; // Digit + tanda minus
+    static char* append(char* first, char* last, T value) {
+        auto result = to_chars(first, last, value);
+        return result.ec == errc() ? result.ptr : nullptr;
+    }
+};
+
+template <>
+struct MessageField<Money> {
+    static constexpr size_t capacity = 21; // "-92233720368547758.08"
+    static char* append(char* first, char* last, Money value) {
+        return value.formatTo(first, last);
+    }
+};
+
+template <typename... Parts>
+constexpr size_t messageCapacity() {
+    return (MessageField<Parts>::capacity + ... + 0);
+}
+
+template <typename... Parts>
+MessageBuffer<messageCapacity<Parts...>()> renderMessage(const Parts&... parts) {
+    MessageBuffer<messageCapacity<Parts...>()> buffer;
+    char* cursor = buffer.begin();
+    ((cursor = MessageField<Parts>::append(cursor, buffer.end(), parts)), ...);
+    buffer.setLength(static_cast<size_t>(cursor - buffer.begin()));
+    return buffer;
+}
+
+// ==================== COLUMNAR ORDER STORE ====================
+// Structure-of-arrays: setiap kolom contiguous, jadi scan total/amount tidak
+// loncat-loncat ke heap seperti vector<Order>.
+
+enum class PaymentTypeCode : uint8_t {
+    None,
+    CreditCard,
+    Wallet,
+    Cash,
+    Other
+};
+
+PaymentTypeCode paymentTypeCodeFor(string_view type) {
+    if (type.empty()) return PaymentTypeCode::None;
+    if (type == "credit_card") return PaymentTypeCode::CreditCard;
+    if (type == "wallet") return PaymentTypeCode::Wallet;
+    if (type == "cash") return PaymentTypeCode::Cash;
+    return PaymentTypeCode::Other;
+}
+
+string paymentTypeName(PaymentTypeCode code) {
+    switch (code) {
+    case PaymentTypeCode::CreditCard: return "credit_card";
+    case PaymentTypeCode::Wallet: return "wallet";
+    case PaymentTypeCode::Cash: return "cash";
+    case PaymentTypeCode::Other: return "other";
+    default: return "";
+    }
+}
+
+// Read-only view ke satu row; description menunjuk ke arena milik OrderTable
+struct OrderView {
+    int id;
+    string_view description;
+    Money totalAmount;
+    PaymentTypeCode paymentType;
+
+    // paymentInfo tidak disimpan di table (tidak dibutuhkan untuk reporting)
+    Order toOrder() const {
+        Order order(id, string(description), totalAmount);
+        if (paymentType != PaymentTypeCode::None) {
+            order.setPaymentInfo(paymentTypeName(paymentType), "");
+        }
+        return order;
+    }
+};
+
+class OrderTable {
+private:
+    vector<int> ids;
+    vector<Money> amounts;
+    vector<PaymentTypeCode> paymentTypes;
+    string descriptionArena;
+    vector<size_t> descriptionOffsets{ 0 }; // Row i = [offsets[i], offsets[i + 1])
+    unordered_map<int, size_t> rowById;
+
+public:
+    void reserve(size_t rows, size_t descriptionBytes = 0) {
+        ids.reserve(rows);
+        amounts.reserve(rows);
+        paymentTypes.reserve(rows);
+        descriptionOffsets.reserve(rows + 1);
+        descriptionArena.reserve(descriptionBytes);
+        rowById.reserve(rows);
+    }
+
+    // Append-only: id yang sama tidak boleh masuk dua kali
+    size_t append(const Order& order) {
+        size_t row = ids.size();
+        if (!rowById.emplace(order.getId(), row).second) {
+            throw invalid_argument("Duplicate order id: " + to_string(order.getId()));
+        }
+
+        ids.push_back(order.getId());
+        amounts.push_back(order.getTotalAmount());
+        paymentTypes.push_back(paymentTypeCodeFor(order.getPaymentType()));
+        descriptionArena += order.getDescription();
+        descriptionOffsets.push_back(descriptionArena.size());
+        return row;
+    }
+
+    size_t size() const { return ids.size(); }
+    bool empty() const { return ids.empty(); }
+
+    // View tetap valid sampai append() berikutnya
+    OrderView row(size_t index) const {
+        size_t begin = descriptionOffsets[index];
+        return OrderView{
+            ids[index],
+            string_view(descriptionArena).substr(begin, descriptionOffsets[index + 1] - begin),
+            amounts[index],
+            paymentTypes[index]
+        };
+    }
+
+    optional<OrderView> findById(int id) const {
+        auto entry = rowById.find(id);
+        if (entry == rowById.end()) {
+            return nullopt;
+        }
+        return row(entry->second);
+    }
+
+    template <typename Visitor>
+    void forEach(Visitor&& visit) const {
+        for (size_t i = 0; i < ids.size(); ++i) {
+            visit(row(i));
+        }
+    }
+
+    // Column access untuk scan reporting
+    const vector<int>& getIds() const { return ids; }
+    const vector<Money>& getAmounts() const { return amounts; }
+    const vector<PaymentTypeCode>& getPaymentTypes() const { return paymentTypes; }
+
+    Money totalAmount() const {
+        return sumMoney(amounts.data(), amounts.size());
     }
 };
 
@@ -45,20 +689,34 @@ public:
 // ❌ BAD EXAMPLE - Tight Coupling
 
 class MySQLDatabase_Bad {
+private:
+    shared_ptr<OutputSink> output;
+
 public:
+    explicit MySQLDatabase_Bad(shared_ptr<OutputSink> sink = defaultOutputSink())
+        : output(sink) {
+    }
+
     void save(const Order& order) {
-        cout << " MySQL: Saving to MySQL database: " << order.toString() << endl;
+        writeOrderLine(*output, " MySQL: Saving to MySQL database: ", order);
     }
 
     Order findById(int id) {
-        return Order(id, "MySQL Order #" + to_string(id), 25.99);
+        return Order(id, "MySQL Order #" + to_string(id), Money(25, 99));
     }
 };
 
 class EmailNotification_Bad {
+private:
+    shared_ptr<OutputSink> output;
+
 public:
-    void send(const string& message) {
-        cout << " Email: Sending email - " << message << endl;
+    explicit EmailNotification_Bad(shared_ptr<OutputSink> sink = defaultOutputSink())
+        : output(sink) {
+    }
+
+    void send(string_view message) {
+        output->writeLine(string(" Email: Sending email - ").append(message));
     }
 };
 
@@ -67,12 +725,14 @@ class BadRestaurantService {
 private:
     MySQLDatabase_Bad* database;          // Direct dependency on concrete class
     EmailNotification_Bad* notification;  // Direct dependency on concrete class
+    shared_ptr<OutputSink> output;
 
 public:
-    BadRestaurantService() {
-        database = new MySQLDatabase_Bad();      // Tight coupling - hard coded!
-        notification = new EmailNotification_Bad(); // Tight coupling - hard coded!
-        cout << " BadRestaurantService: Created with tight coupling" << endl;
+    explicit BadRestaurantService(shared_ptr<OutputSink> sink = defaultOutputSink())
+        : output(sink) {
+        database = new MySQLDatabase_Bad(sink);      // Tight coupling - hard coded!
+        notification = new EmailNotification_Bad(sink); // Tight coupling - hard coded!
+        output->writeLine(" BadRestaurantService: Created with tight coupling");
     }
 
     ~BadRestaurantService() {
@@ -82,8 +742,9 @@ public:
 
     void processOrder(const Order& order) {
         database->save(order);
-        notification->send("Order " + to_string(order.getId()) + " processed!");
-        cout << " Order processed with TIGHT COUPLING" << endl;
-        cout << "   Problem: Sulit ganti database atau notification!" << endl;
+        notification->send(renderMessage("Order ", order.getId(), " processed!"));
+        output->writeLine(" Order processed with TIGHT COUPLING");
+        output->writeLine("   Problem: Sulit ganti database atau notification!");
+        output->endOrder();
     }
 };